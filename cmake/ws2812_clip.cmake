@@ -0,0 +1,56 @@
+# SPDX-License-Identifier: Apache-2.0
+#
+# Build canned animations into the image as compressed clips
+# (src/ws2812_clip.h), encoded at build time by scripts/ws2812_clip.py:
+#
+#   ws2812_clip(<name> IMAGES <file>... [DURATION <ms>] [KEYFRAME_INTERVAL <n>])
+#   ws2812_clip(<name> GENERATE rainbow|ball [DURATION <ms>])
+#
+# Relative image paths are taken from the calling CMakeLists.txt. The clip
+# is registered under <name> ("ws2812 clip play <name>"), and
+# "west build -t ws2812_clip_<name>" encodes just that clip.
+
+set(WS2812_CLIP_TOOL ${CMAKE_CURRENT_LIST_DIR}/../scripts/ws2812_clip.py)
+set(WS2812_CLIP_TEMPLATE ${CMAKE_CURRENT_LIST_DIR}/../src/clips/clip.c.in)
+
+function(ws2812_clip clip_name)
+  cmake_parse_arguments(CLIP "" "GENERATE;DURATION;KEYFRAME_INTERVAL" "IMAGES" ${ARGN})
+
+  set(out_dir ${CMAKE_CURRENT_BINARY_DIR}/clips)
+  set(clip_bin ${out_dir}/${clip_name}.clip)
+  set(clip_inc ${out_dir}/${clip_name}.inc)
+
+  set(args
+    --width ${CONFIG_WS2812_MATRIX_WIDTH}
+    --height ${CONFIG_WS2812_MATRIX_HEIGHT}
+    -o ${clip_bin})
+  if(CLIP_DURATION)
+    list(APPEND args --duration ${CLIP_DURATION})
+  endif()
+  if(CLIP_KEYFRAME_INTERVAL)
+    list(APPEND args --keyframe-interval ${CLIP_KEYFRAME_INTERVAL})
+  endif()
+  if(CLIP_GENERATE)
+    list(APPEND args --generate ${CLIP_GENERATE})
+  elseif(NOT CLIP_IMAGES)
+    message(FATAL_ERROR "ws2812_clip(${clip_name}): give IMAGES or GENERATE")
+  endif()
+
+  set(images)
+  foreach(image ${CLIP_IMAGES})
+    get_filename_component(image ${image} ABSOLUTE BASE_DIR ${CMAKE_CURRENT_SOURCE_DIR})
+    list(APPEND images ${image})
+  endforeach()
+
+  file(MAKE_DIRECTORY ${out_dir})
+  add_custom_command(
+    OUTPUT ${clip_bin}
+    COMMAND ${PYTHON_EXECUTABLE} ${WS2812_CLIP_TOOL} ${args} ${images}
+    DEPENDS ${WS2812_CLIP_TOOL} ${images}
+    COMMENT "Encoding WS2812 clip ${clip_name}"
+  )
+  generate_inc_file_for_target(app ${clip_bin} ${clip_inc} ws2812_clip_${clip_name})
+
+  configure_file(${WS2812_CLIP_TEMPLATE} ${out_dir}/${clip_name}_clip.c @ONLY)
+  target_sources(app PRIVATE ${out_dir}/${clip_name}_clip.c)
+endfunction()
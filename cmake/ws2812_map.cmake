@@ -0,0 +1,142 @@
+# SPDX-License-Identifier: Apache-2.0
+#
+# Generate the compile-time XY -> LED chain index table from the
+# CONFIG_WS2812_MATRIX_* / CONFIG_WS2812_SKIP_LEDS settings.
+#
+#   ws2812_geometry.h   WS2812_PANEL_WIDTH/HEIGHT, WS2812_CHAIN_LEN
+#   ws2812_xy_map.inc   initializer for int16_t map[MATRIX_HEIGHT][MATRIX_WIDTH],
+#                       -1 for pixels that land on a skipped LED
+#   ws2812_row_runs.inc initializer for one { start, step } per logical row:
+#                       the row occupies chain slots start + x * step when
+#                       it is one unbroken run (step +1/-1), step 0 otherwise
+#
+# Both files are only rewritten when their content changes.
+
+function(ws2812_generate_map out_dir)
+  set(w ${CONFIG_WS2812_MATRIX_WIDTH})
+  set(h ${CONFIG_WS2812_MATRIX_HEIGHT})
+  set(rot ${CONFIG_WS2812_MATRIX_ROTATION})
+
+  if(rot EQUAL 90 OR rot EQUAL 270)
+    set(pw ${h})
+    set(ph ${w})
+  elseif(rot EQUAL 0 OR rot EQUAL 180)
+    set(pw ${w})
+    set(ph ${h})
+  else()
+    message(FATAL_ERROR "CONFIG_WS2812_MATRIX_ROTATION must be 0, 90, 180 or 270 (got ${rot})")
+  endif()
+  math(EXPR panel_leds "${pw} * ${ph}")
+
+  # Skipped (dead/bypassed) physical chain positions
+  string(REPLACE "," ";" skip_list "${CONFIG_WS2812_SKIP_LEDS}")
+  set(skip)
+  foreach(s ${skip_list})
+    string(STRIP "${s}" s)
+    if(NOT s STREQUAL "")
+      if(s GREATER_EQUAL panel_leds)
+        message(FATAL_ERROR "CONFIG_WS2812_SKIP_LEDS entry ${s} is outside the ${panel_leds}-LED panel")
+      endif()
+      list(APPEND skip ${s})
+    endif()
+  endforeach()
+  list(REMOVE_DUPLICATES skip)
+  list(LENGTH skip num_skip)
+  math(EXPR chain_len "${panel_leds} - ${num_skip}")
+
+  math(EXPR w_last "${w} - 1")
+  math(EXPR h_last "${h} - 1")
+  set(rows "")
+  set(runs "")
+  foreach(y RANGE ${h_last})
+    set(row "")
+    set(row_indices)
+    foreach(x RANGE ${w_last})
+      set(lx ${x})
+      set(ly ${y})
+      if(CONFIG_WS2812_MATRIX_FLIP_X)
+        math(EXPR lx "${w_last} - ${lx}")
+      endif()
+      if(CONFIG_WS2812_MATRIX_FLIP_Y)
+        math(EXPR ly "${h_last} - ${ly}")
+      endif()
+
+      # Logical image rotated clockwise onto the panel
+      if(rot EQUAL 0)
+        set(px ${lx})
+        set(py ${ly})
+      elseif(rot EQUAL 90)
+        math(EXPR px "${h_last} - ${ly}")
+        set(py ${lx})
+      elseif(rot EQUAL 180)
+        math(EXPR px "${w_last} - ${lx}")
+        math(EXPR py "${h_last} - ${ly}")
+      else()
+        set(px ${ly})
+        math(EXPR py "${w_last} - ${lx}")
+      endif()
+
+      # Panel wiring: rows, odd rows reversed when serpentine
+      math(EXPR odd "${py} % 2")
+      if(CONFIG_WS2812_MATRIX_SERPENTINE AND odd)
+        math(EXPR wire "${py} * ${pw} + ${pw} - 1 - ${px}")
+      else()
+        math(EXPR wire "${py} * ${pw} + ${px}")
+      endif()
+
+      list(FIND skip ${wire} dead)
+      if(NOT dead EQUAL -1)
+        set(index -1)
+      else()
+        set(index ${wire})
+        foreach(s ${skip})
+          if(s LESS wire)
+            math(EXPR index "${index} - 1")
+          endif()
+        endforeach()
+      endif()
+      string(APPEND row "${index}, ")
+      list(APPEND row_indices ${index})
+    endforeach()
+
+    # Does the row map to consecutive chain slots?
+    list(GET row_indices 0 start)
+    set(step 0)
+    if(w GREATER 1)
+      list(GET row_indices 1 second)
+      math(EXPR step "${second} - ${start}")
+      if(NOT (step EQUAL 1 OR step EQUAL -1))
+        set(step 0)
+      endif()
+    endif()
+    set(expect ${start})
+    foreach(index ${row_indices})
+      if(index EQUAL -1 OR NOT index EQUAL expect)
+        set(step 0)
+        break()
+      endif()
+      math(EXPR expect "${expect} + ${step}")
+    endforeach()
+    string(APPEND runs "    { ${start}, ${step} },\n")
+    string(STRIP "${row}" row)
+    string(APPEND rows "    { ${row} },\n")
+  endforeach()
+
+  file(CONFIGURE OUTPUT ${out_dir}/ws2812_geometry.h CONTENT
+"/* Generated by cmake/ws2812_map.cmake - do not edit */
+#ifndef WS2812_GEOMETRY_H
+#define WS2812_GEOMETRY_H
+
+#define WS2812_PANEL_WIDTH  ${pw}
+#define WS2812_PANEL_HEIGHT ${ph}
+#define WS2812_CHAIN_LEN    ${chain_len}
+
+#endif /* WS2812_GEOMETRY_H */
+")
+  file(CONFIGURE OUTPUT ${out_dir}/ws2812_xy_map.inc CONTENT
+"/* Generated by cmake/ws2812_map.cmake - do not edit */
+${rows}")
+  file(CONFIGURE OUTPUT ${out_dir}/ws2812_row_runs.inc CONTENT
+"/* Generated by cmake/ws2812_map.cmake - do not edit */
+${runs}")
+endfunction()
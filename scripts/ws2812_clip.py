@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+"""Encode an image sequence as a WS2812 clip (CONFIG_WS2812_CLIP).
+
+The format is described in src/ws2812_clip.h: key frames and XOR delta
+frames, both run-length coded, with a duration per frame. Each frame is
+stored as whichever of the two is smaller, and every encoded clip is
+decoded again and compared with the input before it is written.
+
+    scripts/ws2812_clip.py --width 16 --height 16 -o intro.clip frame*.ppm
+    scripts/ws2812_clip.py --width 16 --height 16 -o logo.clip logo.gif
+    scripts/ws2812_clip.py --width 16 --height 16 -o rainbow.clip --generate rainbow
+
+Binary PPM (P6) files are read directly; other formats, including animated
+GIFs (with their own frame durations), need Pillow. Images must already be
+the size of the matrix. --generate makes a built-in test animation instead.
+"""
+
+import argparse
+import struct
+import sys
+
+VERSION = 1
+KEY, DELTA = 0, 1
+MAX_RUN = 128
+
+
+def read_ppm(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            pos = data.index(b"\n", pos)
+            continue
+        end = pos
+        while not data[end:end + 1].isspace():
+            end += 1
+        fields.append(data[pos:end])
+        pos = end
+    if fields[0] != b"P6" or fields[3] != b"255":
+        raise ValueError("%s: only 8-bit binary PPM (P6) is supported" % path)
+    width, height = int(fields[1]), int(fields[2])
+    pixels = data[pos + 1:pos + 1 + width * height * 3]
+    return width, height, [tuple(pixels[i:i + 3]) for i in range(0, len(pixels), 3)]
+
+
+def read_images(paths, default_ms):
+    """Yield (width, height, [(r, g, b)...], duration_ms) per frame."""
+    for path in paths:
+        if path.lower().endswith(".ppm"):
+            w, h, pixels = read_ppm(path)
+            yield w, h, pixels, default_ms
+            continue
+        try:
+            from PIL import Image, ImageSequence
+        except ImportError:
+            sys.exit("%s: reading this format needs Pillow (pip install pillow)" % path)
+        with Image.open(path) as im:
+            for frame in ImageSequence.Iterator(im):
+                rgb = frame.convert("RGB")
+                ms = frame.info.get("duration") or default_ms
+                yield rgb.width, rgb.height, list(rgb.getdata()), ms
+
+
+def hsv_to_rgb(h, s, v):
+    """Same integer conversion as hsv_to_rgb() in src/patterns.c."""
+    if s == 0:
+        return v, v, v
+    region = h // 43
+    remainder = (h - region * 43) * 6
+    p = (v * (255 - s)) >> 8
+    q = (v * (255 - ((s * remainder) >> 8))) >> 8
+    t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8
+    return [(v, t, p), (q, v, p), (p, v, t), (p, q, v), (t, p, v), (v, p, q)][min(region, 5)]
+
+
+def generate(kind, width, height, ms):
+    if kind == "rainbow":
+        # The rainbow_sweep pattern, one full turn: every pixel changes
+        for offset in range(0, 256, 2):
+            row = [hsv_to_rgb(((x * 255) // width + offset) & 255, 255, 255)
+                   for x in range(width)]
+            yield width, height, row * height, ms
+    elif kind == "ball":
+        # A 3x3 ball bouncing on black: small deltas
+        x, y, dx, dy = 1, 2, 1, 1
+        for _ in range(4 * (width + height)):
+            pixels = [(0, 0, 0)] * (width * height)
+            for by in range(3):
+                for bx in range(3):
+                    pixels[(y + by) * width + x + bx] = (255, 96, 0)
+            yield width, height, pixels, ms
+            if not 0 <= x + dx <= width - 3:
+                dx = -dx
+            if not 0 <= y + dy <= height - 3:
+                dy = -dy
+            x += dx
+            y += dy
+    else:
+        sys.exit("unknown animation %s" % kind)
+
+
+def encode_runs(pixels):
+    """Run-length code pixels (3-byte tuples, already in G R B order)."""
+    out = bytearray()
+    literal = []
+
+    def flush():
+        if literal:
+            out.append(len(literal) - 1)
+            for p in literal:
+                out.extend(p)
+            literal.clear()
+
+    i = 0
+    while i < len(pixels):
+        j = i + 1
+        while j < len(pixels) and j - i < MAX_RUN and pixels[j] == pixels[i]:
+            j += 1
+        if j - i >= 2:
+            flush()
+            out.append(0x80 + j - i - 1)
+            out.extend(pixels[i])
+            i = j
+        else:
+            literal.append(pixels[i])
+            if len(literal) == MAX_RUN:
+                flush()
+            i += 1
+    flush()
+    return bytes(out)
+
+
+def decode(clip, num_leds):
+    """Reference decoder, mirroring ws2812_clip_next()."""
+    frames = struct.unpack_from("<H", clip, 6)[0]
+    pos = 8
+    current = [(0, 0, 0)] * num_leds
+    for _ in range(frames):
+        kind, _, length = struct.unpack_from("<BHH", clip, pos)
+        run, end = pos + 5, pos + 5 + length
+        i = 0
+        while run < end:
+            c = clip[run]
+            run += 1
+            n = c - 0x7F if c >= 0x80 else c + 1
+            values = [tuple(clip[run:run + 3])] * n if c >= 0x80 else \
+                [tuple(clip[run + 3 * k:run + 3 * k + 3]) for k in range(n)]
+            run += 3 if c >= 0x80 else 3 * n
+            for v in values:
+                if kind == DELTA:
+                    v = tuple(a ^ b for a, b in zip(current[i], v))
+                current[i] = v
+                i += 1
+        pos = end
+        yield list(current)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("images", nargs="*", help="frames in order (PPM, or anything Pillow reads)")
+    parser.add_argument("-o", "--output", required=True)
+    parser.add_argument("--width", type=int, required=True, help="CONFIG_WS2812_MATRIX_WIDTH")
+    parser.add_argument("--height", type=int, required=True, help="CONFIG_WS2812_MATRIX_HEIGHT")
+    parser.add_argument("--duration", type=int, default=50, help="ms per frame (default 50)")
+    parser.add_argument("--keyframe-interval", type=int, default=0,
+                        help="force a key frame every N frames (0: only when smaller)")
+    parser.add_argument("--generate", choices=["rainbow", "ball"],
+                        help="encode a built-in test animation instead of images")
+    args = parser.parse_args()
+
+    if args.generate:
+        source = generate(args.generate, args.width, args.height, args.duration)
+    elif args.images:
+        source = read_images(args.images, args.duration)
+    else:
+        parser.error("give images or --generate")
+
+    num_leds = args.width * args.height
+    body = bytearray()
+    inputs = []
+    previous = None
+    keys = 0
+    for n, (w, h, rgb, ms) in enumerate(source):
+        if (w, h) != (args.width, args.height):
+            sys.exit("frame %d is %dx%d, the matrix is %dx%d" % (n, w, h, args.width, args.height))
+        grb = [(g, r, b) for r, g, b in rgb]
+        inputs.append(grb)
+
+        runs = encode_runs(grb)
+        kind = KEY
+        force_key = args.keyframe_interval and n % args.keyframe_interval == 0
+        if previous is not None and not force_key:
+            delta = encode_runs([tuple(a ^ b for a, b in zip(p, q)) for p, q in zip(previous, grb)])
+            if len(delta) < len(runs):
+                runs, kind = delta, DELTA
+        keys += kind == KEY
+        if len(runs) > 0xFFFF:
+            sys.exit("frame %d does not fit in 64 KB" % n)
+        body += struct.pack("<BHH", kind, min(ms, 0xFFFF), len(runs)) + runs
+        previous = grb
+
+    if not inputs or len(inputs) > 0xFFFF:
+        sys.exit("need 1 to 65535 frames, got %d" % len(inputs))
+    clip = struct.pack("<2sBBBBH", b"WC", VERSION, 0, args.width, args.height, len(inputs)) + body
+
+    for n, (want, got) in enumerate(zip(inputs, decode(clip, num_leds))):
+        if want != got:
+            sys.exit("internal error: frame %d does not decode back" % n)
+
+    with open(args.output, "wb") as f:
+        f.write(clip)
+
+    raw = len(inputs) * num_leds * 3
+    print("%s: %d frames (%d key), %d bytes, %d%% of %d raw" %
+          (args.output, len(inputs), keys, len(clip), len(clip) * 100 // raw, raw))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Stream frames to the WS2812 frame receiver (CONFIG_WS2812_RX).
+
+Sends Adalight frames, each followed by a CRC-8 of the pixel bytes unless
+--no-crc is given (match CONFIG_WS2812_RX_CRC), to a serial port or, on
+native_sim, to the pty the second UART was attached to (printed at boot as
+"uart_1 connected to pseudotty: /dev/pts/N").
+
+    scripts/ws2812_send.py /dev/pts/5 --fps 60
+    scripts/ws2812_send.py /dev/ttyACM0 --baud 2000000 --frames 600
+
+The frames are a moving rainbow, row by row from the top-left corner.
+Only the standard library is used.
+"""
+
+import argparse
+import colorsys
+import os
+import sys
+import termios
+import time
+
+
+def crc8_ccitt(data, crc=0xFF):
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def frame(width, height, t, with_crc):
+    count = width * height - 1
+    hi, lo = count >> 8, count & 0xFF
+    pixels = bytearray()
+    for y in range(height):
+        for x in range(width):
+            r, g, b = colorsys.hsv_to_rgb(((x + y) / (width + height) + t) % 1.0, 1.0, 0.5)
+            pixels += bytes((int(r * 255), int(g * 255), int(b * 255)))
+    out = bytes((ord("A"), ord("d"), ord("a"), hi, lo, hi ^ lo ^ 0x55)) + pixels
+    if with_crc:
+        out += bytes((crc8_ccitt(pixels),))
+    return out
+
+
+def open_port(path, baud):
+    fd = os.open(path, os.O_WRONLY | os.O_NOCTTY)
+    attrs = termios.tcgetattr(fd)
+    attrs[0] = 0                                    # iflag
+    attrs[1] = 0                                    # oflag: no newline translation
+    attrs[2] = termios.CS8 | termios.CLOCAL         # cflag
+    attrs[3] = 0                                    # lflag: raw
+    speed = getattr(termios, "B%d" % baud, None)
+    if speed is not None:
+        attrs[4] = attrs[5] = speed
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port", help="serial device or pty")
+    parser.add_argument("--width", type=int, default=16)
+    parser.add_argument("--height", type=int, default=16)
+    parser.add_argument("--fps", type=float, default=30.0, help="0 sends as fast as possible")
+    parser.add_argument("--frames", type=int, default=0, help="0 runs until interrupted")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--no-crc", action="store_true", help="plain Adalight frames")
+    args = parser.parse_args()
+
+    fd = open_port(args.port, args.baud)
+    period = 1.0 / args.fps if args.fps > 0 else 0.0
+    start = next_due = time.monotonic()
+    sent = 0
+    try:
+        while args.frames == 0 or sent < args.frames:
+            data = frame(args.width, args.height, sent / 100.0, not args.no_crc)
+            view = memoryview(data)
+            while view:
+                view = view[os.write(fd, view):]
+            sent += 1
+            if sent % 100 == 0:
+                rate = sent / (time.monotonic() - start)
+                print("%d frames, %.1f FPS, %d bytes each" % (sent, rate, len(data)),
+                      file=sys.stderr)
+            if period:
+                next_due += period
+                time.sleep(max(0.0, next_due - time.monotonic()))
+    except KeyboardInterrupt:
+        pass
+    finally:
+        os.close(fd)
+
+
+if __name__ == "__main__":
+    main()
@@ -23,6 +23,7 @@
 #include <zephyr/logging/log.h>
 #include "ws2812.h"
 #include "quadrant_simple_test.h"  // Using simple test instead
+#include "ws2812_rx.h"
 
 LOG_MODULE_REGISTER(main, LOG_LEVEL_INF);
 
@@ -31,7 +32,7 @@ int main(void) {
 
     LOG_INF("===========================================");
     LOG_INF("  Zephyr RTOS Thread Priority Demo");
-    LOG_INF("  Board: SAM E54 Xplained Pro");
+    LOG_INF("  Board: %s", CONFIG_BOARD);
     LOG_INF("  16x16 WS2812 LED Matrix");
     LOG_INF("===========================================");
 
@@ -50,12 +51,25 @@ int main(void) {
     ws2812_clear();
     ws2812_update();
 
+#ifdef CONFIG_WS2812_BENCH_SUITE
+    // Before the demo threads start, so nothing competes for the CPU
+    ws2812_bench_suite_run();
+#endif
+
+#ifdef CONFIG_WS2812_RX
+    // The host draws the whole matrix; no demo
+    ret = ws2812_rx_start();
+    if (ret != 0) {
+        return ret;
+    }
+#else
     // Initialize and start the SIMPLE test (two balls)
     simple_test_init();
 
     LOG_INF("");
     LOG_INF("Demo running! Press SW0 to change Q1 priority");
     LOG_INF("");
+#endif
 
     // Main thread just sleeps
     while (1) {
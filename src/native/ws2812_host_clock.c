@@ -0,0 +1,17 @@
+/*
+ * Host monotonic clock for the benchmark suite on native_sim
+ *
+ * Built into the native simulator runner (host libc), not the Zephyr image:
+ * simulated time does not advance while code runs, so the benchmarks time
+ * themselves against the host clock instead.
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+uint64_t ws2812_host_clock_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
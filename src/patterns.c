@@ -1,235 +1,175 @@
-#include "ws2812.h"
-#include <math.h>
+/*
+ * Pattern registry and runner
+ *
+ * Patterns register themselves in an iterable section (see patterns.h), so
+ * the table holds exactly the ones built in. The running pattern is stepped
+ * from a delayable work item (an executor effect with CONFIG_WS2812_ANIM),
+ * and its state lives in one shared buffer, so switching patterns costs
+ * neither a thread nor per-pattern RAM.
+ */
+
+#include "patterns.h"
+#include <string.h>
 #include <stdlib.h>
-
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+#ifdef CONFIG_WS2812_ANIM
+#include "ws2812_anim.h"
+#endif
+#ifdef CONFIG_WS2812_CLIP
+#include "ws2812_clip.h"
 #endif
 
-// Pattern 1: Scrolling wave
-static int wave_offset = 0;
+LOG_MODULE_REGISTER(ws2812_pattern, LOG_LEVEL_INF);
 
-void pattern_wave(void) {
-    for (int y = 0; y < MATRIX_HEIGHT; y++) {
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
-            // Create sine wave pattern
-            int wave_pos = (x + wave_offset) % MATRIX_WIDTH;
-            float sine_val = sin(wave_pos * M_PI / 8.0);
-            uint8_t brightness = (uint8_t)(128 + 127 * sine_val);
+#ifdef CONFIG_WS2812_PATTERNS
 
-            // Red wave
-            rgb_t color = {brightness, brightness, 0};
-            ws2812_set_pixel(x, y, color);
-        }
+static uint8_t pattern_state[CONFIG_WS2812_PATTERN_STATE_SIZE] __aligned(8);
+static const struct ws2812_pattern *active;
+
+// Draw and send one frame of the running pattern
+static void pattern_frame(void) {
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+    if (active != NULL) {
+        active->step(pattern_state);
+        ws2812_update();
     }
-    wave_offset = (wave_offset + 1) % MATRIX_WIDTH;
+    k_mutex_unlock(&matrix_mutex);
 }
 
-// Pattern 2: Bouncing ball
-static float ball_x = 8.0, ball_y = 8.0;
-static float ball_vx = 0.3, ball_vy = 0.2;
+#ifdef CONFIG_WS2812_ANIM
+static void pattern_anim_step(struct ws2812_anim *anim) {
+    pattern_frame();
+}
 
-void pattern_ball(void) {
-    // Update ball physics
-    ball_x += ball_vx;
-    ball_y += ball_vy;
-    
-    // Bounce off walls
-    if (ball_x <= 1 || ball_x >= MATRIX_WIDTH - 2) {
-        ball_vx = -ball_vx;
-        ball_x = (ball_x <= 1) ? 1.1 : MATRIX_WIDTH - 2.1;
-    }
-    if (ball_y <= 1 || ball_y >= MATRIX_HEIGHT - 2) {
-        ball_vy = -ball_vy;
-        ball_y = (ball_y <= 1) ? 1.1 : MATRIX_HEIGHT - 2.1;
-    }
-    
-    // Draw ball (3x3 blue)
-    for (int dy = -1; dy <= 1; dy++) {
-        for (int dx = -1; dx <= 1; dx++) {
-            int px = (int)(ball_x + 0.5) + dx;
-            int py = (int)(ball_y + 0.5) + dy;
+static struct ws2812_anim pattern_anim = {
+    .name = "pattern",
+    .step = pattern_anim_step,
+    .cls = WS2812_ANIM_LOW,
+};
+#else
+static uint32_t period_ms;
+
+static void pattern_work_handler(struct k_work *work) {
+    pattern_frame();
+    k_work_schedule(k_work_delayable_from_work(work), K_MSEC(period_ms));
+}
 
-            if (px >= 0 && px < MATRIX_WIDTH && py >= 0 && py < MATRIX_HEIGHT) {
-                rgb_t current = ws2812_get_pixel(px, py);
-                // Add blue, keep other colors
-                current.b = 255;
-                ws2812_set_pixel(px, py, current);
-            }
+static K_WORK_DELAYABLE_DEFINE(pattern_work, pattern_work_handler);
+#endif
+
+const struct ws2812_pattern *ws2812_pattern_find(const char *name) {
+    STRUCT_SECTION_FOREACH(ws2812_pattern, p) {
+        if (strcmp(p->name, name) == 0) {
+            return p;
         }
     }
+    return NULL;
 }
 
-// Pattern 3: Breathing border
-static uint8_t breath_brightness = 0;
-static int8_t breath_direction = 1;
-
-void pattern_breath(void) {
-    // Update brightness
-    breath_brightness += breath_direction * 5;
-    
-    if (breath_brightness >= 250) {
-        breath_brightness = 250;
-        breath_direction = -1;
-    } else if (breath_brightness <= 5) {
-        breath_brightness = 5;
-        breath_direction = 1;
+int ws2812_pattern_run(const struct ws2812_pattern *pattern, uint16_t fps) {
+    if (fps > 1000) {
+        return -EINVAL;
     }
-    
-    // Draw green breathing border
-    // Top and bottom edges
-    for (int x = 0; x < MATRIX_WIDTH; x++) {
-        rgb_t current_top = ws2812_get_pixel(x, 0);
-        rgb_t current_bottom = ws2812_get_pixel(x, MATRIX_HEIGHT - 1);
 
-        current_top.g = breath_brightness;
-        current_bottom.g = breath_brightness;
+    // Stop stepping first, so no step sees the state being replaced
+#ifdef CONFIG_WS2812_ANIM
+    ws2812_anim_stop(&pattern_anim);
+#else
+    struct k_work_sync sync;
 
-        ws2812_set_pixel(x, 0, current_top);
-        ws2812_set_pixel(x, MATRIX_HEIGHT - 1, current_bottom);
+    k_work_cancel_delayable_sync(&pattern_work, &sync);
+#endif
+
+#ifdef CONFIG_WS2812_CLIP
+    // A clip draws the whole matrix too
+    if (pattern != NULL) {
+        ws2812_clip_play(NULL);
     }
-    
-    // Left and right edges
-    for (int y = 1; y < MATRIX_HEIGHT - 1; y++) {
-        rgb_t current_left = ws2812_get_pixel(0, y);
-        rgb_t current_right = ws2812_get_pixel(MATRIX_WIDTH - 1, y);
-        
-        current_left.g = breath_brightness;
-        current_right.g = breath_brightness;
-        
-        ws2812_set_pixel(0, y, current_left);
-        ws2812_set_pixel(MATRIX_WIDTH - 1, y, current_right);
+#endif
+
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+    active = pattern;
+    if (pattern != NULL) {
+        memset(pattern_state, 0, sizeof(pattern_state));
+        if (pattern->init != NULL) {
+            pattern->init(pattern_state);
+        }
     }
-}
+    k_mutex_unlock(&matrix_mutex);
 
-// Pattern 4: Random twinkle
-void pattern_twinkle(void) {
-    // Add random white sparkles
-    for (int i = 0; i < 5; i++) {
-        int x = rand() % MATRIX_WIDTH;
-        int y = rand() % MATRIX_HEIGHT;
-        uint8_t brightness = 128 + (rand() % 128);
-        
-        rgb_t current = ws2812_get_pixel(x, y);
-        
-        // Add white
-        uint8_t add = brightness / 3;
-        current.r = (current.r + add > 255) ? 255 : current.r + add;
-        current.g = (current.g + add > 255) ? 255 : current.g + add;
-        current.b = (current.b + add > 255) ? 255 : current.b + add;
-        
-        ws2812_set_pixel(x, y, current);
+    if (pattern == NULL) {
+        LOG_INF("Pattern stopped");
+        return 0;
     }
-    
-    // Fade all pixels
-    for (int y = 0; y < MATRIX_HEIGHT; y++) {
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
-            rgb_t current = ws2812_get_pixel(x, y);
-            
-            current.r = (uint8_t)(current.r * 0.95);
-            current.g = (uint8_t)(current.g * 0.95);
-            current.b = (uint8_t)(current.b * 0.95);
-            
-            ws2812_set_pixel(x, y, current);
-        }
+
+    if (fps == 0) {
+        fps = pattern->fps;
     }
+#ifdef CONFIG_WS2812_ANIM
+    pattern_anim.period_ms = MAX(1000 / fps, 1);
+    ws2812_anim_start(&pattern_anim);
+#else
+    period_ms = MAX(1000 / fps, 1);
+    k_work_schedule(&pattern_work, K_NO_WAIT);
+#endif
+    LOG_INF("Pattern %s at %u fps", pattern->name, fps);
+    return 0;
 }
 
-// ISR Pattern: Flash burst (yellow)
-void pattern_flash_burst(void) {
-    for (int frame = 0; frame < 10; frame++) {
-        uint8_t brightness = 255 - (frame * 25);
-        
-        k_mutex_lock(&matrix_mutex, K_FOREVER);
-        
-        // Fill entire matrix with yellow
-        for (int y = 0; y < MATRIX_HEIGHT; y++) {
-            for (int x = 0; x < MATRIX_WIDTH; x++) {
-                rgb_t yellow = {brightness, brightness, 0};
-                ws2812_set_pixel(x, y, yellow);
-            }
-        }
-        
-        ws2812_update();
-        k_mutex_unlock(&matrix_mutex);
-        
-        k_msleep(30);
-    }
+const struct ws2812_pattern *ws2812_pattern_active(void) {
+    return active;
 }
 
-// Pattern 5: Priority Visualizer
-// Each row represents a priority level, shows scheduling activity
-#define NUM_PRIORITY_LEVELS 8
-static uint8_t priority_activity[NUM_PRIORITY_LEVELS] = {0};
-static uint8_t priority_colors[NUM_PRIORITY_LEVELS][3] = {
-    {255, 0, 0},     // Priority 0: Red (highest)
-    {255, 128, 0},   // Priority 1: Orange
-    {255, 255, 0},   // Priority 2: Yellow
-    {0, 255, 0},     // Priority 3: Green
-    {0, 255, 255},   // Priority 4: Cyan
-    {0, 0, 255},     // Priority 5: Blue
-    {128, 0, 255},   // Priority 6: Purple
-    {255, 0, 255}    // Priority 7: Magenta (lowest)
-};
+#ifdef CONFIG_WS2812_SHELL
+static int cmd_pattern_list(const struct shell *sh, size_t argc, char **argv) {
+    STRUCT_SECTION_FOREACH(ws2812_pattern, p) {
+        shell_print(sh, "%c %-22s %3u fps, %u bytes of state", p == active ? '*' : ' ',
+                    p->name, p->fps, p->state_size);
+    }
+    shell_print(sh, "State buffer: %d bytes shared by all patterns",
+                CONFIG_WS2812_PATTERN_STATE_SIZE);
+    return 0;
+}
 
-void pattern_priority_visualizer(void) {
-    // Simulate thread activity at different priority levels
-    // In a real implementation, this would read actual thread states
+static int cmd_pattern_set(const struct shell *sh, size_t argc, char **argv) {
+    const struct ws2812_pattern *p = NULL;
+    unsigned long fps = 0;
+    int err = 0;
 
-    // Decay existing activity
-    for (int p = 0; p < NUM_PRIORITY_LEVELS; p++) {
-        if (priority_activity[p] > 0) {
-            priority_activity[p] = (uint8_t)(priority_activity[p] * 0.9);
+    if (argc > 2) {
+        fps = shell_strtoul(argv[2], 10, &err);
+        if (err != 0 || fps > UINT16_MAX) {
+            shell_error(sh, "Bad frame rate %s", argv[2]);
+            return -EINVAL;
         }
     }
 
-    // Simulate random thread wakeups at different priorities
-    // Higher priority threads are more active (lower numbers = higher priority)
-    for (int p = 0; p < NUM_PRIORITY_LEVELS; p++) {
-        // Higher priority = more likely to be active
-        int threshold = 50 + (p * 30);  // 50, 80, 110, 140, etc.
-        if ((rand() % 255) > threshold) {
-            priority_activity[p] = 255;
+    if (strcmp(argv[1], "off") != 0) {
+        p = ws2812_pattern_find(argv[1]);
+        if (p == NULL) {
+            shell_error(sh, "No pattern %s (see \"ws2812 pattern list\")", argv[1]);
+            return -ENOENT;
         }
     }
-
-    // Draw visualization: each row represents a priority
-    // Two rows per priority level for 16-row matrix
-    for (int p = 0; p < NUM_PRIORITY_LEVELS; p++) {
-        int row1 = p * 2;
-        int row2 = p * 2 + 1;
-
-        if (row1 >= MATRIX_HEIGHT) break;
-
-        // Create moving bar effect based on activity
-        uint8_t brightness = priority_activity[p];
-        int bar_length = (brightness * MATRIX_WIDTH) / 255;
-
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
-            rgb_t color;
-            if (x < bar_length) {
-                // Active portion - full color
-                color.r = (priority_colors[p][0] * brightness) / 255;
-                color.g = (priority_colors[p][1] * brightness) / 255;
-                color.b = (priority_colors[p][2] * brightness) / 255;
-            } else {
-                // Inactive portion - dim
-                color.r = priority_colors[p][0] / 10;
-                color.g = priority_colors[p][1] / 10;
-                color.b = priority_colors[p][2] / 10;
-            }
-
-            ws2812_set_pixel(x, row1, color);
-            if (row2 < MATRIX_HEIGHT) {
-                ws2812_set_pixel(x, row2, color);
-            }
-        }
+    if (ws2812_pattern_run(p, (uint16_t)fps) < 0) {
+        shell_error(sh, "Bad frame rate %s", argv[2]);
+        return -EINVAL;
     }
+    return 0;
 }
 
-// Pattern 6: Rainbow Sweep
-// Simple rainbow gradient that scrolls horizontally
-static int rainbow_offset = 0;
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_pattern,
+    SHELL_CMD(list, NULL, "List built-in patterns", cmd_pattern_list),
+    SHELL_CMD_ARG(set, NULL, "<name|off> [fps]  Run a pattern over the whole matrix",
+                  cmd_pattern_set, 2, 1),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_SUBCMD_ADD((ws2812), pattern, &sub_pattern, "Full-matrix patterns", NULL, 1, 0);
+#endif
+
+#endif /* CONFIG_WS2812_PATTERNS */
 
 // Helper function: Convert HSV to RGB
 // H: 0-255, S: 0-255, V: 0-255
@@ -274,22 +214,3 @@ rgb_t hsv_to_rgb(uint8_t h, uint8_t s, uint8_t v) {
 
     return rgb;
 }
-
-void pattern_rainbow_sweep(void) {
-    // Fill entire matrix with rainbow gradient
-    for (int y = 0; y < MATRIX_HEIGHT; y++) {
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
-            // Calculate hue based on x position and offset
-            // Each column gets a different color from the rainbow
-            uint8_t hue = ((x * 255) / MATRIX_WIDTH + rainbow_offset) % 256;
-
-            // Convert HSV to RGB (full saturation and value)
-            rgb_t color = hsv_to_rgb(hue, 255, 255);
-
-            ws2812_set_pixel(x, y, color);
-        }
-    }
-
-    // Scroll the rainbow to the right
-    rainbow_offset = (rainbow_offset + 2) % 256;
-}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef PATTERNS_H
+#define PATTERNS_H
+
+#include "ws2812.h"
+#include <zephyr/sys/iterable_sections.h>
+
+// Full-matrix animation patterns, one per file in src/patterns/. Each is
+// built only when its CONFIG_WS2812_PATTERN_* symbol is set and registers
+// itself with WS2812_PATTERN_DEFINE, so a disabled pattern leaves no code,
+// state or table entry behind.
+//
+// A pattern keeps its state in a struct of its own type. Only the running
+// pattern has state: it lives in one shared buffer of
+// CONFIG_WS2812_PATTERN_STATE_SIZE bytes, zeroed and handed to init() when
+// the pattern is selected. step() draws one frame into the framebuffer and
+// runs with matrix_mutex held.
+struct ws2812_pattern {
+    const char *name;
+    void (*init)(void *state);  // May be NULL: zeroed state is enough
+    void (*step)(void *state);
+    uint16_t state_size;
+    uint16_t fps;               // Default frame rate
+};
+
+#define WS2812_PATTERN_DEFINE(_name, _init, _step, _state_type, _fps)          \
+    BUILD_ASSERT(sizeof(_state_type) <= CONFIG_WS2812_PATTERN_STATE_SIZE,      \
+                 "raise CONFIG_WS2812_PATTERN_STATE_SIZE for " #_name);        \
+    const STRUCT_SECTION_ITERABLE(ws2812_pattern, ws2812_pattern_##_name) = { \
+        .name = #_name, .init = (_init), .step = (_step),                      \
+        .state_size = sizeof(_state_type), .fps = (_fps),                      \
+    }
+
+// For patterns without state
+struct ws2812_pattern_no_state {
+};
+
+// Look a pattern up by name; NULL if it isn't built in
+const struct ws2812_pattern *ws2812_pattern_find(const char *name);
+
+// Run pattern (NULL stops the running one) at fps frames per second, or at
+// its default rate if fps is 0. Steps run from a work item, so switching
+// never creates a thread. Returns -EINVAL for fps above 1000.
+int ws2812_pattern_run(const struct ws2812_pattern *pattern, uint16_t fps);
+
+// Running pattern, or NULL
+const struct ws2812_pattern *ws2812_pattern_active(void);
+
+// H, S, V: 0-255
+rgb_t hsv_to_rgb(uint8_t h, uint8_t s, uint8_t v);
+
+#endif /* PATTERNS_H */
@@ -0,0 +1,66 @@
+// Bouncing ball (3x3, blue over whatever is below it)
+
+#include "patterns.h"
+#include "ws2812_fixed.h"
+
+struct ball_state {
+    q16_t x, y;     // Center, Q16.16 pixels
+    q16_t vx, vy;
+    int8_t drawn_x, drawn_y;
+    bool drawn;
+};
+
+static void ball_init(void *state) {
+    struct ball_state *s = state;
+
+    s->x = Q16(8.0);
+    s->y = Q16(8.0);
+    s->vx = Q16(0.3);
+    s->vy = Q16(0.2);
+}
+
+// Set the blue channel of the 3x3 square centered on (cx, cy)
+static void ball_paint(int cx, int cy, uint8_t blue) {
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            int px = cx + dx;
+            int py = cy + dy;
+
+            if (px >= 0 && px < MATRIX_WIDTH && py >= 0 && py < MATRIX_HEIGHT) {
+                rgb_t current = ws2812_get_pixel(px, py);
+
+                // Add blue, keep other colors
+                current.b = blue;
+                ws2812_set_pixel(px, py, current);
+            }
+        }
+    }
+}
+
+static void ball_step(void *state) {
+    struct ball_state *s = state;
+
+    s->x += s->vx;
+    s->y += s->vy;
+
+    // Bounce off walls
+    if (s->x <= Q16(1) || s->x >= q16_from_int(MATRIX_WIDTH - 2)) {
+        s->vx = -s->vx;
+        s->x = (s->x <= Q16(1)) ? Q16(1.1) : q16_from_int(MATRIX_WIDTH - 2) - Q16(0.1);
+    }
+    if (s->y <= Q16(1) || s->y >= q16_from_int(MATRIX_HEIGHT - 2)) {
+        s->vy = -s->vy;
+        s->y = (s->y <= Q16(1)) ? Q16(1.1) : q16_from_int(MATRIX_HEIGHT - 2) - Q16(0.1);
+    }
+
+    // Take the blue back off where the ball was, then draw it
+    if (s->drawn) {
+        ball_paint(s->drawn_x, s->drawn_y, 0);
+    }
+    s->drawn_x = q16_round(s->x);
+    s->drawn_y = q16_round(s->y);
+    s->drawn = true;
+    ball_paint(s->drawn_x, s->drawn_y, 255);
+}
+
+WS2812_PATTERN_DEFINE(ball, ball_init, ball_step, struct ball_state, 20);
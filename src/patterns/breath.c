@@ -0,0 +1,53 @@
+// Breathing green border
+
+#include "patterns.h"
+
+struct breath_state {
+    uint8_t brightness;
+    int8_t direction;
+};
+
+static void breath_init(void *state) {
+    struct breath_state *s = state;
+
+    s->direction = 1;
+}
+
+static void breath_step(void *state) {
+    struct breath_state *s = state;
+
+    s->brightness += s->direction * 5;
+    if (s->brightness >= 250) {
+        s->brightness = 250;
+        s->direction = -1;
+    } else if (s->brightness <= 5) {
+        s->brightness = 5;
+        s->direction = 1;
+    }
+
+    // Top and bottom edges
+    for (int x = 0; x < MATRIX_WIDTH; x++) {
+        rgb_t current_top = ws2812_get_pixel(x, 0);
+        rgb_t current_bottom = ws2812_get_pixel(x, MATRIX_HEIGHT - 1);
+
+        current_top.g = s->brightness;
+        current_bottom.g = s->brightness;
+
+        ws2812_set_pixel(x, 0, current_top);
+        ws2812_set_pixel(x, MATRIX_HEIGHT - 1, current_bottom);
+    }
+
+    // Left and right edges
+    for (int y = 1; y < MATRIX_HEIGHT - 1; y++) {
+        rgb_t current_left = ws2812_get_pixel(0, y);
+        rgb_t current_right = ws2812_get_pixel(MATRIX_WIDTH - 1, y);
+
+        current_left.g = s->brightness;
+        current_right.g = s->brightness;
+
+        ws2812_set_pixel(0, y, current_left);
+        ws2812_set_pixel(MATRIX_WIDTH - 1, y, current_right);
+    }
+}
+
+WS2812_PATTERN_DEFINE(breath, breath_init, breath_step, struct breath_state, 20);
@@ -0,0 +1,17 @@
+// Yellow flash fading out over 10 frames, then again
+
+#include "patterns.h"
+
+struct flash_burst_state {
+    uint8_t frame;
+};
+
+static void flash_burst_step(void *state) {
+    struct flash_burst_state *s = state;
+    uint8_t brightness = 255 - (s->frame * 25);
+
+    ws2812_fill((rgb_t){brightness, brightness, 0});
+    s->frame = (s->frame + 1) % 10;
+}
+
+WS2812_PATTERN_DEFINE(flash_burst, NULL, flash_burst_step, struct flash_burst_state, 33);
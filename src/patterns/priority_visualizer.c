@@ -0,0 +1,65 @@
+// Priority visualizer: each pair of rows is a priority level in use, highest
+// first, with a bar as long as that level's CPU share (ws2812_cpu.h). Each
+// thread at the level has its own stretch of the bar, alternately bright and
+// half bright.
+
+#include "patterns.h"
+#include "ws2812_cpu.h"
+
+#define NUM_PRIORITY_LEVELS (MATRIX_HEIGHT / 2)
+
+static const uint8_t priority_colors[8][3] = {
+    {255, 0, 0},     // Red (highest in use)
+    {255, 128, 0},   // Orange
+    {255, 255, 0},   // Yellow
+    {0, 255, 0},     // Green
+    {0, 255, 255},   // Cyan
+    {0, 0, 255},     // Blue
+    {128, 0, 255},   // Purple
+    {255, 0, 255}    // Magenta (lowest)
+};
+
+static rgb_t level_color(int level, int div) {
+    const uint8_t *c = priority_colors[level % ARRAY_SIZE(priority_colors)];
+
+    return (rgb_t){ .r = c[0] / div, .g = c[1] / div, .b = c[2] / div };
+}
+
+static void priority_visualizer_step(void *state) {
+    static struct ws2812_cpu_thread threads[CONFIG_WS2812_CPU_MAX_THREADS];
+    struct ws2812_cpu_summary sum;
+    int8_t level_of[WS2812_CPU_PRIOS];
+    uint8_t bar_x[NUM_PRIORITY_LEVELS] = {0};
+    uint8_t drawn[NUM_PRIORITY_LEVELS] = {0};
+    int levels = 0;
+
+    ws2812_cpu_sample();
+    int n = ws2812_cpu_get(threads, ARRAY_SIZE(threads), &sum);
+
+    // One level per priority that has threads; the lowest ones are left
+    // out if there are more than the rows
+    for (int p = 0; p < WS2812_CPU_PRIOS; p++) {
+        level_of[p] = sum.prio_threads[p] && levels < NUM_PRIORITY_LEVELS ? levels++ : -1;
+    }
+
+    // Dim background for levels in use, black below
+    for (int l = 0; l < NUM_PRIORITY_LEVELS; l++) {
+        ws2812_fill_rect(0, l * 2, MATRIX_WIDTH, 2,
+                         l < levels ? level_color(l, 10) : (rgb_t){0, 0, 0});
+    }
+
+    for (int i = 0; i < n; i++) {
+        int l = level_of[threads[i].prio - K_HIGHEST_THREAD_PRIO];
+        int len = (threads[i].permille * MATRIX_WIDTH + 500) / 1000;
+
+        if (l < 0 || len == 0) {
+            continue;
+        }
+        // fill_rect clips a bar that runs off the matrix
+        ws2812_fill_rect(bar_x[l], l * 2, len, 2, level_color(l, drawn[l]++ % 2 ? 2 : 1));
+        bar_x[l] = MIN(bar_x[l] + len, MATRIX_WIDTH);
+    }
+}
+
+WS2812_PATTERN_DEFINE(priority_visualizer, NULL, priority_visualizer_step,
+                      struct ws2812_pattern_no_state, 20);
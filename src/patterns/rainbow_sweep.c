@@ -0,0 +1,28 @@
+// Rainbow gradient scrolling horizontally
+
+#include "patterns.h"
+
+struct rainbow_sweep_state {
+    uint8_t offset;
+};
+
+static void rainbow_sweep_step(void *state) {
+    struct rainbow_sweep_state *s = state;
+    // Every row is identical: compute it once
+    rgb_t row[MATRIX_WIDTH];
+
+    for (int x = 0; x < MATRIX_WIDTH; x++) {
+        // Each column gets a different color from the rainbow
+        uint8_t hue = (x * 255) / MATRIX_WIDTH + s->offset;
+
+        row[x] = hsv_to_rgb(hue, 255, 255);
+    }
+    for (int y = 0; y < MATRIX_HEIGHT; y++) {
+        ws2812_write_row(0, y, row, MATRIX_WIDTH);
+    }
+
+    // Scroll the rainbow to the right
+    s->offset += 2;
+}
+
+WS2812_PATTERN_DEFINE(rainbow_sweep, NULL, rainbow_sweep_step, struct rainbow_sweep_state, 33);
@@ -0,0 +1,27 @@
+// Random white sparkles fading out
+
+#include "patterns.h"
+#include "ws2812_fixed.h"
+#include <stdlib.h>
+
+static void twinkle_step(void *state) {
+    for (int i = 0; i < 5; i++) {
+        int x = rand() % MATRIX_WIDTH;
+        int y = rand() % MATRIX_HEIGHT;
+        uint8_t brightness = 128 + (rand() % 128);
+        rgb_t current = ws2812_get_pixel(x, y);
+
+        // Add white
+        uint8_t add = brightness / 3;
+        current.r = qadd8(current.r, add);
+        current.g = qadd8(current.g, add);
+        current.b = qadd8(current.b, add);
+
+        ws2812_set_pixel(x, y, current);
+    }
+
+    // Fade all pixels
+    ws2812_fade(Q8(0.95));
+}
+
+WS2812_PATTERN_DEFINE(twinkle, NULL, twinkle_step, struct ws2812_pattern_no_state, 10);
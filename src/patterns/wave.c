@@ -0,0 +1,28 @@
+// Scrolling wave
+
+#include "patterns.h"
+#include "ws2812_fixed.h"
+
+struct wave_state {
+    uint8_t offset;
+};
+
+static void wave_step(void *state) {
+    struct wave_state *s = state;
+    // Every row is identical: compute it once
+    rgb_t row[MATRIX_WIDTH];
+
+    for (int x = 0; x < MATRIX_WIDTH; x++) {
+        // One period per 16 columns: 16 sin8 steps per column
+        int wave_pos = (x + s->offset) % MATRIX_WIDTH;
+        uint8_t brightness = sin8(wave_pos * 16);
+
+        row[x] = (rgb_t){brightness, brightness, 0};
+    }
+    for (int y = 0; y < MATRIX_HEIGHT; y++) {
+        ws2812_write_row(0, y, row, MATRIX_WIDTH);
+    }
+    s->offset = (s->offset + 1) % MATRIX_WIDTH;
+}
+
+WS2812_PATTERN_DEFINE(wave, NULL, wave_step, struct wave_state, 10);
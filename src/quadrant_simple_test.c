@@ -1,32 +1,43 @@
 /*
  * Simple Single Quadrant Test - Based on working pattern_ball
- * Tests one bouncing ball in Quadrant 1 only
+ * One bouncing ball (and optional particles) per quadrant, all in one
+ * entity pool; each quadrant thread steps its own share of it
  * Now with SW0 button to cycle thread priorities!
  */
 
 #include "quadrant_demo.h"
+#include "quadrant_simple_test.h"
+#include "ws2812_layer.h"
+#include "ws2812_frame.h"
+#include "ws2812_fixed.h"
+#include "ws2812_entity.h"
+#include "ws2812_anim.h"
+#ifdef CONFIG_WS2812_CLIP
+#include "ws2812_clip.h"
+#endif
+#include <stdlib.h>
+#include <string.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/drivers/gpio.h>
-#include <math.h>
 
 LOG_MODULE_REGISTER(quad_simple, LOG_LEVEL_INF);
 
-// Button configuration - SW0 on SAM E54 Xplained Pro
-#define SW0_NODE DT_ALIAS(sw0)
-#if DT_NODE_HAS_STATUS(SW0_NODE, okay)
-static const struct gpio_dt_spec button = GPIO_DT_SPEC_GET(SW0_NODE, gpios);
-static struct gpio_callback button_cb_data;
-
 // Priority cycling - Zephyr uses lower numbers for higher priority
 // We'll cycle through: 2 (highest), 4 (high), 6 (medium), 8 (low)
 static const int priority_levels[] = {2, 4, 6, 8};
 static const char *priority_names[] = {"HIGHEST", "HIGH", "MEDIUM", "LOW"};
-static const float speed_levels[] = {1.5f, 1.0f, 0.8f, 1.2f};  // Match Q2, unique, Q3, Q4 speeds
+static const q16_t speed_levels[] = {Q16(1.5), Q16(1.0), Q16(0.8), Q16(1.2)};  // Match Q2, unique, Q3, Q4 speeds
 static int current_priority_index = 1;  // Start at priority 4 (HIGH)
 static volatile bool priority_changed = false;
 
+// Button configuration - SW0 on SAM E54 Xplained Pro
+#define SW0_NODE DT_ALIAS(sw0)
+#if DT_NODE_HAS_STATUS(SW0_NODE, okay)
+static const struct gpio_dt_spec button = GPIO_DT_SPEC_GET(SW0_NODE, gpios);
+static struct gpio_callback button_cb_data;
+
 // Button press handler
 void button_pressed(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
 {
@@ -39,30 +50,240 @@ void button_pressed(const struct device *dev, struct gpio_callback *cb, uint32_t
 }
 #endif
 
-// Simple ball states for quadrant 1 and 2 (no trail buffer)
-static float ball1_x = 4.0f;
-static float ball1_y = 4.0f;
-static float ball1_vx = 0.3f;
-static float ball1_vy = 0.25f;
-static float ball1_speed = 1.0f;  // Speed multiplier (1.0 = normal)
+// Every ball, plus CONFIG_SAMPLE_PARTICLES particles spread over the
+// quadrants, lives in one entity pool. Quadrant q owns QUAD_ENTITIES
+// entities from quad_first(q): its particles, then its ball, so the ball is
+// drawn on top.
+#define QUAD_PARTICLES (CONFIG_SAMPLE_PARTICLES / 4)
+#define QUAD_ENTITIES  (QUAD_PARTICLES + 1)
+
+WS2812_ENTITY_POOL_DEFINE(quad_pool, 4 * QUAD_ENTITIES);
+
+static struct ws2812_entity_view quad_views[4] = {
+    { .x = 0, .y = 0, .w = QUAD_WIDTH, .h = QUAD_HEIGHT },
+    { .x = QUAD_WIDTH, .y = 0, .w = QUAD_WIDTH, .h = QUAD_HEIGHT },
+    { .x = 0, .y = QUAD_HEIGHT, .w = QUAD_WIDTH, .h = QUAD_HEIGHT },
+    { .x = QUAD_WIDTH, .y = QUAD_HEIGHT, .w = QUAD_WIDTH, .h = QUAD_HEIGHT },
+};
+
+// Ball velocity in pixels per frame at speed 1.0
+#define BALL_VX Q16(0.3)
+#define BALL_VY Q16(0.25)
+
+// Q1 starts at 1.0x, Q2 1.5x faster, Q3 0.8x slower, Q4 1.2x faster
+static const q16_t quad_speed[4] = {Q16(1.0), Q16(1.5), Q16(0.8), Q16(1.2)};
+
+static inline int quad_first(int quad) {
+    return quad * QUAD_ENTITIES;
+}
+
+static inline int quad_ball(int quad) {
+    return quad_first(quad) + QUAD_PARTICLES;
+}
+
+#ifdef CONFIG_WS2812_ANIM
+// Quadrants and the display are executor effects instead of threads
+static struct ws2812_anim quad_anims[4];
+static struct ws2812_anim display_anim;
+
+// Executor class standing in for demo thread priority level (2, 4, 6 or 8),
+// one class per level so Q1 keeps its contrast with the other quadrants
+static enum ws2812_anim_class level_class(int level) {
+    return level <= 2 ? WS2812_ANIM_HIGH :
+           level <= 4 ? WS2812_ANIM_ABOVE_NORMAL :
+           level <= 6 ? WS2812_ANIM_NORMAL : WS2812_ANIM_LOW;
+}
+#endif
+
+#ifdef CONFIG_WS2812_FRAME_CLOCK
+// Quadrant threads and the display thread all run once per frame tick
+static struct ws2812_frame_client quad_frame[4];
+static struct ws2812_frame_client display_frame;
+#endif
+
+#ifndef CONFIG_WS2812_ANIM
+#if CONFIG_SAMPLE_MUTEX_WAIT_REPORT_MS > 0
+// How late each quadrant thread woke from its frame sleep
+static struct ws2812_anim_jitter quad_jitter[4];
+#endif
+
+// Wait for the next frame: one frame tick, or the free-running period
+static void quad_next_frame(int quad) {
+#ifdef CONFIG_WS2812_FRAME_CLOCK
+    ws2812_frame_wait(&quad_frame[quad]);
+#elif CONFIG_SAMPLE_MUTEX_WAIT_REPORT_MS > 0
+    k_ticks_t due = k_uptime_ticks() + k_ms_to_ticks_ceil64(50);
+
+    k_msleep(50);
+    ws2812_anim_jitter_add(&quad_jitter[quad], k_uptime_ticks() - due);
+#else
+    k_msleep(50);  // 20 FPS - speed controlled by the ballN_speed multipliers
+#endif
+}
+#endif
+
+#ifdef CONFIG_WS2812_LAYERS
+// Each quadrant draws into its own 8x8 layer and never takes matrix_mutex
+WS2812_LAYER_DEFINE(quad1_layer, 0, 0, 8, 8, 0, WS2812_BLEND_OPAQUE);
+WS2812_LAYER_DEFINE(quad2_layer, 8, 0, 8, 8, 0, WS2812_BLEND_OPAQUE);
+WS2812_LAYER_DEFINE(quad3_layer, 0, 8, 8, 8, 0, WS2812_BLEND_OPAQUE);
+WS2812_LAYER_DEFINE(quad4_layer, 8, 8, 8, 8, 0, WS2812_BLEND_OPAQUE);
+
+static struct ws2812_layer *const quad_layers[4] = {
+    &quad1_layer, &quad2_layer, &quad3_layer, &quad4_layer
+};
+#endif
+
+#if CONFIG_SAMPLE_MUTEX_WAIT_REPORT_MS > 0 || defined(CONFIG_SAMPLE_PROFILER)
+#define QUAD_PROFILE
+#endif
+
+// Frames drawn by each quadrant since boot
+volatile uint32_t thread_cycle_count[4];
+
+#ifdef QUAD_PROFILE
+// Publish profile of the four quadrants and the display, in cycles. wait is
+// the matrix_mutex wait (the layer commit with CONFIG_WS2812_LAYERS), hold
+// the time from getting the mutex to releasing it (drawing into the layer).
+// Each thread only touches its own slot; readers may race with an update,
+// which is fine for a diagnostic.
+#define PROF_DISPLAY   4
+#define PROF_PRODUCERS 5
+
+struct quad_prof {
+    uint64_t wait_total;
+    uint64_t hold_total;
+    uint32_t wait_max;
+    uint32_t hold_max;
+    uint32_t frames;
+    uint32_t held_at;  // Cycle count when the mutex was taken
+};
+
+static struct quad_prof prof[PROF_PRODUCERS];
+static int64_t prof_since;  // Uptime in ms of the last reset
+
+static const char *const prof_names[PROF_PRODUCERS] = {
+    "Q1", "Q2", "Q3", "Q4", "display"
+};
+
+static void prof_wait(int p, uint32_t start) {
+    uint32_t now = k_cycle_get_32();
+    uint32_t wait = now - start;
+
+    prof[p].wait_total += wait;
+    prof[p].wait_max = MAX(prof[p].wait_max, wait);
+    prof[p].held_at = now;
+}
+
+static void prof_hold(int p) {
+    uint32_t hold = k_cycle_get_32() - prof[p].held_at;
+
+    prof[p].hold_total += hold;
+    prof[p].hold_max = MAX(prof[p].hold_max, hold);
+    prof[p].frames++;
+}
+
+static void prof_reset(void) {
+    memset(prof, 0, sizeof(prof));
+    prof_since = k_uptime_get();
+}
+
+struct prof_summary {
+    uint32_t fps_x10;
+    uint32_t wait_avg_us, wait_max_us;
+    uint32_t hold_avg_us, hold_max_us;
+    uint32_t held_pct;  // Share of the time holding the mutex
+};
+
+// Averages and rate of producer p since the last reset
+static void prof_summarize(int p, struct prof_summary *s) {
+    const struct quad_prof *pr = &prof[p];
+    uint32_t n = MAX(pr->frames, 1);
+    int64_t ms = MAX(k_uptime_get() - prof_since, 1);
+
+    s->fps_x10 = (uint32_t)((uint64_t)pr->frames * 10000 / ms);
+    s->wait_avg_us = k_cyc_to_us_floor32((uint32_t)(pr->wait_total / n));
+    s->wait_max_us = k_cyc_to_us_floor32(pr->wait_max);
+    s->hold_avg_us = k_cyc_to_us_floor32((uint32_t)(pr->hold_total / n));
+    s->hold_max_us = k_cyc_to_us_floor32(pr->hold_max);
+    s->held_pct = (uint32_t)MIN(k_cyc_to_us_floor64(pr->hold_total) / 10 / ms, 100);
+}
+#endif
+
+// Whether the demo may draw into the framebuffer (matrix_mutex held): a
+// playing clip owns the whole matrix. Layers need no check, since the
+// compositor holds off while the clip plays.
+static bool matrix_free(void) {
+#if defined(CONFIG_WS2812_CLIP) && !defined(CONFIG_WS2812_LAYERS)
+    return ws2812_clip_playing() == NULL;
+#else
+    return true;
+#endif
+}
+
+// Start drawing a frame for quadrant thread quad (0-3)
+static void quad_begin(int quad) {
+#ifdef CONFIG_WS2812_LAYERS
+#ifdef QUAD_PROFILE
+    // Drawing into the layer counts as holding
+    prof[quad].held_at = k_cycle_get_32();
+#endif
+#else
+#ifdef QUAD_PROFILE
+    uint32_t start = k_cycle_get_32();
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+    prof_wait(quad, start);
+#else
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+#endif
+#endif
+}
+
+// Finish the frame: publish the layer, or release matrix_mutex
+static void quad_end(int quad) {
+    thread_cycle_count[quad]++;
+#ifdef QUAD_PROFILE
+    prof_hold(quad);
+#endif
+#ifdef CONFIG_WS2812_LAYERS
+#ifdef QUAD_PROFILE
+    uint32_t start = k_cycle_get_32();
+    ws2812_layer_commit(quad_layers[quad]);
+    prof_wait(quad, start);
+#else
+    ws2812_layer_commit(quad_layers[quad]);
+#endif
+#else
+    k_mutex_unlock(&matrix_mutex);
+#endif
+}
 
-static float ball2_x = 4.0f;
-static float ball2_y = 4.0f;
-static float ball2_vx = 0.3f;
-static float ball2_vy = 0.25f;
-static float ball2_speed = 1.5f;  // 1.5x faster
+#if CONFIG_SAMPLE_MUTEX_WAIT_REPORT_MS > 0
+// Log and reset the publish profile
+static void report_mutex_wait(void) {
+    for (int p = 0; p < PROF_PRODUCERS; p++) {
+        struct prof_summary s;
 
-static float ball3_x = 4.0f;
-static float ball3_y = 4.0f;
-static float ball3_vx = 0.3f;
-static float ball3_vy = 0.25f;
-static float ball3_speed = 0.8f;  // 0.8x speed (slower)
+        prof_summarize(p, &s);
+        LOG_INF("%s publish wait: avg %u us, max %u us; hold: avg %u us, max %u us; %u.%u FPS",
+                prof_names[p], s.wait_avg_us, s.wait_max_us, s.hold_avg_us, s.hold_max_us,
+                s.fps_x10 / 10, s.fps_x10 % 10);
+    }
 
-static float ball4_x = 4.0f;
-static float ball4_y = 4.0f;
-static float ball4_vx = 0.3f;
-static float ball4_vy = 0.25f;
-static float ball4_speed = 1.2f;  // 1.2x faster
+    for (int q = 0; q < 4; q++) {
+        // Start of each frame against when it was due, since boot
+#ifdef CONFIG_WS2812_ANIM
+        const struct ws2812_anim_jitter *j = &quad_anims[q].jitter;
+#else
+        const struct ws2812_anim_jitter *j = &quad_jitter[q];
+#endif
+        LOG_INF("Q%d frame start: late avg %u us, max %u us, %u frames missed", q + 1,
+                j->runs ? (uint32_t)(j->late_total_us / j->runs) : 0, j->late_max_us,
+                j->missed);
+    }
+    prof_reset();
+}
+#endif
 
 // Quadrant colors (rgb_t struct is {g, r, b} order, but LEDs expect BGR order)
 // To get specific colors with BGR LEDs: B=1st byte, G=2nd byte, R=3rd byte
@@ -92,313 +313,326 @@ static rgb_t get_priority_color(int priority_level) {
     return colors[0];
 }
 
-void simple_quad1_animation(int priority) {
-    // Update physics with speed multiplier
-    ball1_x += ball1_vx * ball1_speed;
-    ball1_y += ball1_vy * ball1_speed;
-
-    // Bounce off quadrant walls (8x8, ball is 2x2 so max is 6.0)
-    if (ball1_x <= 0.5f || ball1_x >= 6.5f) {
-        ball1_vx = -ball1_vx;
-        ball1_x = (ball1_x <= 0.5f) ? 0.6f : 6.4f;
-    }
-    if (ball1_y <= 0.5f || ball1_y >= 6.5f) {
-        ball1_vy = -ball1_vy;
-        ball1_y = (ball1_y <= 0.5f) ? 0.6f : 6.4f;
-    }
+// Set a ball's speed, keeping its direction
+static void ball_set_speed(int ball, q16_t speed) {
+    q16_t vx = q16_mul(BALL_VX, speed);
+    q16_t vy = q16_mul(BALL_VY, speed);
 
-    // Get color based on priority
-    rgb_t ball_color = get_priority_color(priority);
-
-    // Clear ONLY the old ball position (4 pixels) instead of entire quadrant
-    // This prevents overwriting other quadrants when we call ws2812_update()
-    static int last_x = -1, last_y = -1;
-    if (last_x >= 0) {
-        for (int dy = 0; dy <= 1; dy++) {
-            for (int dx = 0; dx <= 1; dx++) {
-                int px = last_x + dx;
-                int py = last_y + dy;
-                if (px >= 0 && px < 8 && py >= 0 && py < 8) {
-                    ws2812_set_pixel(px, py, (rgb_t){0, 0, 0});
-                }
-            }
-        }
-    }
-    last_x = (int)(ball1_x);
-    last_y = (int)(ball1_y);
+    quad_pool.vx[ball] = quad_pool.vx[ball] < 0 ? -vx : vx;
+    quad_pool.vy[ball] = quad_pool.vy[ball] < 0 ? -vy : vy;
+}
 
-    // Draw ball (2x2) in quadrant 1
-    for (int dy = 0; dy <= 1; dy++) {
-        for (int dx = 0; dx <= 1; dx++) {
-            int px = (int)(ball1_x) + dx;
-            int py = (int)(ball1_y) + dy;
+// Color quadrant quad's ball, and its particles at a quarter of that
+static void quad_set_color(int quad, rgb_t color) {
+    rgb_t dim = { scale8(color.g, Q8(0.25)), scale8(color.r, Q8(0.25)),
+                  scale8(color.b, Q8(0.25)) };
 
-            if (px >= 0 && px < 8 && py >= 0 && py < 8) {
-                ws2812_set_pixel(px, py, ball_color);
-            }
-        }
+    for (int i = quad_first(quad); i < quad_ball(quad); i++) {
+        quad_pool.color[i] = dim;
     }
+    quad_pool.color[quad_ball(quad)] = color;
 }
 
-void simple_quad2_animation(int priority) {
-    // Update physics with speed multiplier
-    ball2_x += ball2_vx * ball2_speed;
-    ball2_y += ball2_vy * ball2_speed;
+// Fill the pool: particles at random positions and velocities, then the
+// ball in the middle of each quadrant. The benchmark suite may have done it
+// already.
+static void quad_entities_init(void) {
+    static const int colors[4] = {4, 10, 11, 12};  // Q1 at HIGH, then Q2-Q4
 
-    // Bounce off quadrant walls (8x8, ball is 2x2 so max is 6.0)
-    if (ball2_x <= 0.5f || ball2_x >= 6.5f) {
-        ball2_vx = -ball2_vx;
-        ball2_x = (ball2_x <= 0.5f) ? 0.6f : 6.4f;
-    }
-    if (ball2_y <= 0.5f || ball2_y >= 6.5f) {
-        ball2_vy = -ball2_vy;
-        ball2_y = (ball2_y <= 0.5f) ? 0.6f : 6.4f;
+    if (quad_pool.count > 0) {
+        return;
     }
 
-    // Get color based on priority
-    rgb_t ball_color = get_priority_color(priority);
-
-    // Clear ONLY the old ball position (4 pixels) instead of entire quadrant
-    // This prevents overwriting other quadrants when we call ws2812_update()
-    static int last_x = -1, last_y = -1;
-    if (last_x >= 0) {
-        for (int dy = 0; dy <= 1; dy++) {
-            for (int dx = 0; dx <= 1; dx++) {
-                int px = last_x + dx + 8;
-                int py = last_y + dy;
-                if (px >= 8 && px < 16 && py >= 0 && py < 8) {
-                    ws2812_set_pixel(px, py, (rgb_t){0, 0, 0});
-                }
-            }
+    for (int q = 0; q < 4; q++) {
+#ifdef CONFIG_WS2812_LAYERS
+        quad_views[q].layer = quad_layers[q];
+#endif
+        for (int p = 0; p < QUAD_PARTICLES; p++) {
+            struct ws2812_entity_desc particle = {
+                .x = Q16(0.6) + ((rand() % ((QUAD_WIDTH - 2) * 256)) << 8),
+                .y = Q16(0.6) + ((rand() % ((QUAD_HEIGHT - 2) * 256)) << 8),
+                .vx = ((rand() % 129) - 64) << 8,  // Up to 0.25 pixels per frame
+                .vy = ((rand() % 129) - 64) << 8,
+                .w = 1,
+                .h = 1,
+            };
+
+            ws2812_entity_add(&quad_pool, &quad_views[q], &particle);
         }
-    }
-    last_x = (int)(ball2_x);
-    last_y = (int)(ball2_y);
-
-    // Draw ball (2x2) in quadrant 2
-    for (int dy = 0; dy <= 1; dy++) {
-        for (int dx = 0; dx <= 1; dx++) {
-            int px = (int)(ball2_x) + dx + 8;  // +8 offset for quadrant 2
-            int py = (int)(ball2_y) + dy;
 
-            if (px >= 8 && px < 16 && py >= 0 && py < 8) {
-                ws2812_set_pixel(px, py, ball_color);
-            }
-        }
+        struct ws2812_entity_desc ball = {
+            .x = Q16(4.0),
+            .y = Q16(4.0),
+            .vx = q16_mul(BALL_VX, quad_speed[q]),
+            .vy = q16_mul(BALL_VY, quad_speed[q]),
+            .w = 2,
+            .h = 2,
+        };
+
+        ws2812_entity_add(&quad_pool, &quad_views[q], &ball);
+        quad_set_color(q, get_priority_color(colors[q]));
     }
 }
 
-void simple_quad3_animation(int priority) {
-    // Update physics with speed multiplier
-    ball3_x += ball3_vx * ball3_speed;
-    ball3_y += ball3_vy * ball3_speed;
+// Apply a button press to Q1: thread priority (executor class with
+// CONFIG_WS2812_ANIM), ball speed and color. At
+// the priority of another quadrant it also copies that ball's position and
+// velocity, so both move in step and only scheduling tells them apart.
+static void quad1_apply_priority(void) {
+    int level = priority_levels[current_priority_index];
+    int ball = quad_ball(0);
+    int match = -1;
+
+#ifdef CONFIG_WS2812_ANIM
+    ws2812_anim_set_class(&quad_anims[0], level_class(level));
+#else
+    k_thread_priority_set(k_current_get(), level);
+#endif
 
-    // Bounce off quadrant walls (8x8, ball is 2x2 so max is 6.0)
-    if (ball3_x <= 0.5f || ball3_x >= 6.5f) {
-        ball3_vx = -ball3_vx;
-        ball3_x = (ball3_x <= 0.5f) ? 0.6f : 6.4f;
-    }
-    if (ball3_y <= 0.5f || ball3_y >= 6.5f) {
-        ball3_vy = -ball3_vy;
-        ball3_y = (ball3_y <= 0.5f) ? 0.6f : 6.4f;
+    switch (level) {
+    case 2: match = quad_ball(1); break;
+    case 6: match = quad_ball(2); break;
+    case 8: match = quad_ball(3); break;
+    // Priority 4 keeps its own unique pattern
     }
 
-    // Get color based on priority
-    rgb_t ball_color = get_priority_color(priority);
-
-    // Clear ONLY the old ball position (4 pixels) instead of entire quadrant
-    // This prevents overwriting other quadrants when we call ws2812_update()
-    static int last_x = -1, last_y = -1;
-    if (last_x >= 0) {
-        for (int dy = 0; dy <= 1; dy++) {
-            for (int dx = 0; dx <= 1; dx++) {
-                int px = last_x + dx;
-                int py = last_y + dy + 8;
-                if (px >= 0 && px < 8 && py >= 8 && py < 16) {
-                    ws2812_set_pixel(px, py, (rgb_t){0, 0, 0});
-                }
-            }
-        }
+    if (match >= 0) {
+        quad_pool.x[ball] = quad_pool.x[match];
+        quad_pool.y[ball] = quad_pool.y[match];
+        quad_pool.vx[ball] = quad_pool.vx[match];
+        quad_pool.vy[ball] = quad_pool.vy[match];
+    } else {
+        ball_set_speed(ball, speed_levels[current_priority_index]);
     }
-    last_x = (int)(ball3_x);
-    last_y = (int)(ball3_y);
+    quad_set_color(0, get_priority_color(level));
 
-    // Draw ball (2x2) in quadrant 3
-    for (int dy = 0; dy <= 1; dy++) {
-        for (int dx = 0; dx <= 1; dx++) {
-            int px = (int)(ball3_x) + dx;  // No x offset for left side
-            int py = (int)(ball3_y) + dy + 8;  // +8 offset for bottom half
+    int speed_x10 = q16_round(speed_levels[current_priority_index] * 10);
 
-            if (px >= 0 && px < 8 && py >= 8 && py < 16) {
-                ws2812_set_pixel(px, py, ball_color);
-            }
-        }
-    }
+    LOG_INF("Q1 now at priority %s (%d), speed %d.%dx - watch the ball color and speed change!",
+            priority_names[current_priority_index], level, speed_x10 / 10, speed_x10 % 10);
 }
 
-void simple_quad4_animation(int priority) {
-    // Update physics with speed multiplier
-    ball4_x += ball4_vx * ball4_speed;
-    ball4_y += ball4_vy * ball4_speed;
-
-    // Bounce off quadrant walls (8x8, ball is 2x2 so max is 6.0)
-    if (ball4_x <= 0.5f || ball4_x >= 6.5f) {
-        ball4_vx = -ball4_vx;
-        ball4_x = (ball4_x <= 0.5f) ? 0.6f : 6.4f;
-    }
-    if (ball4_y <= 0.5f || ball4_y >= 6.5f) {
-        ball4_vy = -ball4_vy;
-        ball4_y = (ball4_y <= 0.5f) ? 0.6f : 6.4f;
+// One frame of quadrant quad: step and draw its own run of the pool
+static void quad_step(int quad) {
+    // Q1 follows the button: priority, speed and color
+    if (quad == 0 && priority_changed) {
+        priority_changed = false;
+        quad1_apply_priority();
     }
 
-    // Get color based on priority
-    rgb_t ball_color = get_priority_color(priority);
-
-    // Clear ONLY the old ball position (4 pixels) instead of entire quadrant
-    // This prevents overwriting other quadrants when we call ws2812_update()
-    static int last_x = -1, last_y = -1;
-    if (last_x >= 0) {
-        for (int dy = 0; dy <= 1; dy++) {
-            for (int dx = 0; dx <= 1; dx++) {
-                int px = last_x + dx + 8;
-                int py = last_y + dy + 8;
-                if (px >= 8 && px < 16 && py >= 8 && py < 16) {
-                    ws2812_set_pixel(px, py, (rgb_t){0, 0, 0});
-                }
-            }
-        }
+    quad_begin(quad);
+    if (matrix_free()) {
+        ws2812_entity_update(&quad_pool, quad_first(quad), QUAD_ENTITIES);
     }
-    last_x = (int)(ball4_x);
-    last_y = (int)(ball4_y);
-
-    // Draw ball (2x2) in quadrant 4
-    for (int dy = 0; dy <= 1; dy++) {
-        for (int dx = 0; dx <= 1; dx++) {
-            int px = (int)(ball4_x) + dx + 8;  // +8 x offset for right side
-            int py = (int)(ball4_y) + dy + 8;  // +8 y offset for bottom half
+    // Display thread handles ws2812_update() now
+    quad_end(quad);
+}
 
-            if (px >= 8 && px < 16 && py >= 8 && py < 16) {
-                ws2812_set_pixel(px, py, ball_color);
-            }
-        }
-    }
+#ifdef CONFIG_WS2812_ANIM
+static void quad_anim_step(struct ws2812_anim *anim) {
+    quad_step(POINTER_TO_INT(anim->user_data));
 }
+#else
+// Quadrant threads
+K_THREAD_STACK_ARRAY_DEFINE(quad_stacks, 4, CONFIG_SAMPLE_QUAD_STACK_SIZE);
+static struct k_thread quad_threads[4];
 
-// Quadrant 1 thread
-K_THREAD_STACK_DEFINE(simple_quad1_stack, 1024);
-struct k_thread simple_quad1_thread_data;
+static void quad_thread_entry(void *quad_arg, void *b, void *c) {
+    int quad = POINTER_TO_INT(quad_arg);
 
-void simple_quad1_thread_entry(void *a, void *b, void *c) {
-    LOG_INF("Quadrant 1 thread started - priority demo ball");
+    LOG_INF("Quadrant %d thread started - %d entities", quad + 1, QUAD_ENTITIES);
 
     while (1) {
-        // Check if priority changed and update this thread's priority AND speed
-        if (priority_changed) {
-            k_thread_priority_set(k_current_get(), priority_levels[current_priority_index]);
-            ball1_speed = speed_levels[current_priority_index];  // Update speed to match priority
-
-            // Copy position and velocity from matching quadrant
-            switch (priority_levels[current_priority_index]) {
-                case 2:  // Match Q2
-                    ball1_x = ball2_x;
-                    ball1_y = ball2_y;
-                    ball1_vx = ball2_vx;
-                    ball1_vy = ball2_vy;
-                    break;
-                case 6:  // Match Q3
-                    ball1_x = ball3_x;
-                    ball1_y = ball3_y;
-                    ball1_vx = ball3_vx;
-                    ball1_vy = ball3_vy;
-                    break;
-                case 8:  // Match Q4
-                    ball1_x = ball4_x;
-                    ball1_y = ball4_y;
-                    ball1_vx = ball4_vx;
-                    ball1_vy = ball4_vy;
-                    break;
-                // Priority 4 keeps its own unique pattern
-            }
+        quad_step(quad);
+        quad_next_frame(quad);
+    }
+}
+#endif
 
-            priority_changed = false;  // Reset flag after applying
-            LOG_INF("Q1 now at priority %s (%d), speed %.1fx - watch the ball color and speed change!",
-                    priority_names[current_priority_index],
-                    priority_levels[current_priority_index],
-                    ball1_speed);
-        }
+void simple_test_render_frame(void) {
+    quad_entities_init();
 
-        k_mutex_lock(&matrix_mutex, K_FOREVER);
-        // Pass current priority level to animation for dynamic color
-        simple_quad1_animation(priority_levels[current_priority_index]);
-        // Display thread handles ws2812_update() now
-        k_mutex_unlock(&matrix_mutex);
-        k_msleep(50);  // 20 FPS - speed controlled by ball1_speed multiplier
+    for (int q = 0; q < 4; q++) {
+        quad_begin(q);
+        ws2812_entity_update(&quad_pool, quad_first(q), QUAD_ENTITIES);
+        quad_end(q);
     }
 }
 
-// Quadrant 2 thread
-K_THREAD_STACK_DEFINE(simple_quad2_stack, 1024);
-struct k_thread simple_quad2_thread_data;
+#ifdef CONFIG_SAMPLE_PROFILER_OVERLAY
+// The quadrants aim for one frame every 50 ms
+#define QUAD_TARGET_FPS 20
+
+// A bar along the bottom row of each quadrant: its length is the frame rate
+// achieved against QUAD_TARGET_FPS, its color the share of the frame period
+// spent waiting to publish. Updated once a second by the display.
+static struct {
+    uint8_t len[4];
+    rgb_t color[4];
+    uint32_t frames[4];
+    uint64_t wait[4];
+    int64_t at;
+} bars;
+
+#ifdef CONFIG_WS2812_LAYERS
+// Black is transparent, so the balls show through beside the bars
+WS2812_LAYER_DEFINE(bar_top_layer, 0, QUAD_HEIGHT - 1, 2 * QUAD_WIDTH, 1, 1, WS2812_BLEND_KEYED);
+WS2812_LAYER_DEFINE(bar_bottom_layer, 0, 2 * QUAD_HEIGHT - 1, 2 * QUAD_WIDTH, 1, 1,
+                    WS2812_BLEND_KEYED);
+#endif
 
-void simple_quad2_thread_entry(void *a, void *b, void *c) {
-    LOG_INF("Quadrant 2 thread started - fixed priority (highest=2)");
+// Recompute the bars; true if a new window has started
+static bool overlay_refresh(void) {
+    int64_t now = k_uptime_get();
+    int64_t ms = now - bars.at;
 
-    while (1) {
-        k_mutex_lock(&matrix_mutex, K_FOREVER);
-        simple_quad2_animation(10);  // Fixed cyan color (index 10)
-        // Display thread handles ws2812_update() now
-        k_mutex_unlock(&matrix_mutex);
-        k_msleep(50);  // 20 FPS - speed controlled by ball2_speed multiplier
+    if (ms < 1000) {
+        return false;
     }
+
+    for (int q = 0; q < 4; q++) {
+        uint32_t frames = thread_cycle_count[q] - bars.frames[q];
+        // The profile may have been reset since the last window
+        uint64_t wait = prof[q].wait_total >= bars.wait[q] ? prof[q].wait_total - bars.wait[q]
+                                                          : prof[q].wait_total;
+        uint32_t wait_pct = frames ? (uint32_t)(k_cyc_to_us_floor64(wait) * QUAD_TARGET_FPS /
+                                                (frames * 10000ULL))
+                                   : 100;
+
+        bars.len[q] = CLAMP(frames * 1000ULL * QUAD_WIDTH / (ms * QUAD_TARGET_FPS), 1, QUAD_WIDTH);
+        // rgb_t is {g, r, b} on the wire, shown as blue, green, red (see below)
+        bars.color[q] = wait_pct < 5 ? (rgb_t){0, 32, 0} :      // Green
+                        wait_pct < 25 ? (rgb_t){0, 32, 32} :    // Yellow
+                        (rgb_t){0, 0, 32};                      // Red
+        bars.frames[q] = thread_cycle_count[q];
+        bars.wait[q] = prof[q].wait_total;
+    }
+    bars.at = now;
+    return true;
 }
 
-// Quadrant 3 thread
-K_THREAD_STACK_DEFINE(simple_quad3_stack, 1024);
-struct k_thread simple_quad3_thread_data;
+// Draw the bars over the quadrants (matrix_mutex held)
+static void overlay_draw(void) {
+    bool changed = overlay_refresh();
 
-void simple_quad3_thread_entry(void *a, void *b, void *c) {
-    LOG_INF("Quadrant 3 thread started - fixed priority (medium=6)");
+#ifdef CONFIG_WS2812_LAYERS
+    if (!changed) {
+        return;
+    }
+    for (int q = 0; q < 4; q++) {
+        struct ws2812_layer *layer = q < 2 ? &bar_top_layer : &bar_bottom_layer;
 
-    while (1) {
-        k_mutex_lock(&matrix_mutex, K_FOREVER);
-        simple_quad3_animation(11);  // Fixed yellow color (index 11)
-        // Display thread handles ws2812_update() now
-        k_mutex_unlock(&matrix_mutex);
-        k_msleep(50);  // 20 FPS - speed controlled by ball3_speed multiplier
+        for (int x = 0; x < QUAD_WIDTH; x++) {
+            ws2812_layer_set_pixel(layer, (q % 2) * QUAD_WIDTH + x, 0,
+                                   x < bars.len[q] ? bars.color[q] : (rgb_t){0, 0, 0});
+        }
     }
-}
+    ws2812_layer_commit(&bar_top_layer);
+    ws2812_layer_commit(&bar_bottom_layer);
+#else
+    // Straight into the framebuffer, every frame, as the balls may have
+    // been drawn over the row since
+    ARG_UNUSED(changed);
+    if (!matrix_free()) {
+        return;
+    }
+    for (int q = 0; q < 4; q++) {
+        int x = (q % 2) * QUAD_WIDTH;
+        int y = (q / 2 + 1) * QUAD_HEIGHT - 1;
 
-// Quadrant 4 thread
-K_THREAD_STACK_DEFINE(simple_quad4_stack, 1024);
-struct k_thread simple_quad4_thread_data;
+        ws2812_fill_rect(x, y, bars.len[q], 1, bars.color[q]);
+        ws2812_fill_rect(x + bars.len[q], y, QUAD_WIDTH - bars.len[q], 1, (rgb_t){0, 0, 0});
+    }
+#endif
+}
+#endif
 
-void simple_quad4_thread_entry(void *a, void *b, void *c) {
-    LOG_INF("Quadrant 4 thread started - fixed priority (lowest=8)");
+// Refresh the LEDs with the current buffer contents
+static void display_step(void) {
+#if CONFIG_SAMPLE_MUTEX_WAIT_REPORT_MS > 0
+    static int64_t next_report = CONFIG_SAMPLE_MUTEX_WAIT_REPORT_MS;
+#endif
 
-    while (1) {
-        k_mutex_lock(&matrix_mutex, K_FOREVER);
-        simple_quad4_animation(12);  // Fixed blue color (index 12)
-        // Display thread handles ws2812_update() now
-        k_mutex_unlock(&matrix_mutex);
-        k_msleep(50);  // 20 FPS - speed controlled by ball4_speed multiplier
+#ifdef QUAD_PROFILE
+    uint32_t start = k_cycle_get_32();
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+    prof_wait(PROF_DISPLAY, start);
+#else
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+#endif
+#ifdef CONFIG_SAMPLE_PROFILER_OVERLAY
+    overlay_draw();
+#endif
+    // With CONFIG_WS2812_ASYNC the mutex is only held while encoding
+    ws2812_update();
+#ifdef QUAD_PROFILE
+    prof_hold(PROF_DISPLAY);
+#endif
+#if CONFIG_SAMPLE_MUTEX_WAIT_REPORT_MS > 0
+    if (k_uptime_get() >= next_report) {
+        report_mutex_wait();
+        next_report += CONFIG_SAMPLE_MUTEX_WAIT_REPORT_MS;
     }
+#endif
+    k_mutex_unlock(&matrix_mutex);
 }
 
+#ifdef CONFIG_WS2812_ANIM
+static void display_anim_step(struct ws2812_anim *anim) {
+    display_step();
+}
+#else
 // Display thread - handles all LED refreshes at fixed rate
-K_THREAD_STACK_DEFINE(display_stack, 1024);
+K_THREAD_STACK_DEFINE(display_stack, CONFIG_SAMPLE_DISPLAY_STACK_SIZE);
 struct k_thread display_thread_data;
 
 void display_thread_entry(void *a, void *b, void *c) {
     LOG_INF("Display thread started - 50 FPS refresh");
 
     while (1) {
-        k_mutex_lock(&matrix_mutex, K_FOREVER);
-        ws2812_update();  // Refresh LEDs with current buffer contents
-        k_mutex_unlock(&matrix_mutex);
+        display_step();
+#ifdef CONFIG_WS2812_FRAME_CLOCK
+        // Highest priority, so it commits before the producers start the next frame
+        ws2812_frame_wait(&display_frame);
+#else
         k_msleep(20);  // 50 FPS (20ms per frame)
+#endif
+    }
+}
+#endif
+
+#if defined(CONFIG_SAMPLE_PROFILER) && defined(CONFIG_WS2812_SHELL)
+static int cmd_prof(const struct shell *sh, size_t argc, char **argv) {
+    shell_print(sh, "%-8s %6s %17s %17s %5s", "", "FPS", "wait avg/max us", "hold avg/max us",
+                "held");
+    for (int p = 0; p < PROF_PRODUCERS; p++) {
+        struct prof_summary s;
+
+        prof_summarize(p, &s);
+        shell_print(sh, "%-8s %4u.%u %8u/%-8u %8u/%-8u %4u%%", prof_names[p], s.fps_x10 / 10,
+                    s.fps_x10 % 10, s.wait_avg_us, s.wait_max_us, s.hold_avg_us, s.hold_max_us,
+                    s.held_pct);
     }
+    shell_print(sh, "Over %u ms; wait is %s", (uint32_t)(k_uptime_get() - prof_since),
+                IS_ENABLED(CONFIG_WS2812_LAYERS) ? "the layer commit" : "for matrix_mutex");
+    return 0;
+}
+
+static int cmd_prof_reset(const struct shell *sh, size_t argc, char **argv) {
+    prof_reset();
+    shell_print(sh, "Profile cleared");
+    return 0;
 }
 
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_prof,
+    SHELL_CMD(reset, NULL, "Clear the profile", cmd_prof_reset),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_SUBCMD_ADD((ws2812), prof, &sub_prof, "Quadrant demo publish profile [reset]", cmd_prof,
+                 1, 0);
+#endif
+
 void simple_test_init(void) {
     LOG_INF("===========================================");
     LOG_INF("  Zephyr Thread Priority Demo");
@@ -445,35 +679,66 @@ void simple_test_init(void) {
     ws2812_clear();
     k_mutex_unlock(&matrix_mutex);
 
-    // Create quadrant 1 thread - Variable priority (starts at HIGH = 4)
-    k_thread_create(&simple_quad1_thread_data, simple_quad1_stack, 1024,
-                    simple_quad1_thread_entry, NULL, NULL, NULL,
-                    4, 0, K_NO_WAIT);  // Start at HIGH priority
-    k_thread_name_set(&simple_quad1_thread_data, "quad1");
-
-    // Create quadrant 2 thread - Fixed HIGH priority (2)
-    k_thread_create(&simple_quad2_thread_data, simple_quad2_stack, 1024,
-                    simple_quad2_thread_entry, NULL, NULL, NULL,
-                    2, 0, K_NO_WAIT);  // Highest - always fast
-    k_thread_name_set(&simple_quad2_thread_data, "quad2");
-
-    // Create quadrant 3 thread - Fixed MEDIUM priority (6)
-    k_thread_create(&simple_quad3_thread_data, simple_quad3_stack, 1024,
-                    simple_quad3_thread_entry, NULL, NULL, NULL,
-                    6, 0, K_NO_WAIT);  // Medium speed
-    k_thread_name_set(&simple_quad3_thread_data, "quad3");
-
-    // Create quadrant 4 thread - Fixed LOW priority (8)
-    k_thread_create(&simple_quad4_thread_data, simple_quad4_stack, 1024,
-                    simple_quad4_thread_entry, NULL, NULL, NULL,
-                    8, 0, K_NO_WAIT);  // Lowest - slowest
-    k_thread_name_set(&simple_quad4_thread_data, "quad4");
+#ifdef CONFIG_WS2812_LAYERS
+    for (int q = 0; q < 4; q++) {
+        ws2812_layer_register(quad_layers[q]);
+    }
+#ifdef CONFIG_SAMPLE_PROFILER_OVERLAY
+    ws2812_layer_register(&bar_top_layer);
+    ws2812_layer_register(&bar_bottom_layer);
+#endif
+#endif
+
+    quad_entities_init();
+
+#ifdef CONFIG_WS2812_FRAME_CLOCK
+    for (int q = 0; q < 4; q++) {
+        static const char *const names[] = { "quad1", "quad2", "quad3", "quad4" };
+        ws2812_frame_register(&quad_frame[q], names[q]);
+    }
+    ws2812_frame_register(&display_frame, "display");
+    ws2812_frame_start();
+#endif
+
+    // Q1 starts at HIGH priority (4); Q2 is highest (2), Q3 medium (6), Q4 lowest (8)
+    static const int quad_priority[4] = {4, 2, 6, 8};
+    static const char *const quad_names[4] = {"quad1", "quad2", "quad3", "quad4"};
+
+#ifdef CONFIG_WS2812_ANIM
+    for (int q = 0; q < 4; q++) {
+        quad_anims[q] = (struct ws2812_anim){
+            .name = quad_names[q],
+            .step = quad_anim_step,
+            .period_ms = 50,  // 20 FPS
+            .cls = level_class(quad_priority[q]),
+            .user_data = INT_TO_POINTER(q),
+        };
+        ws2812_anim_start(&quad_anims[q]);
+    }
+
+    display_anim = (struct ws2812_anim){
+        .name = "display",
+        .step = display_anim_step,
+        .period_ms = 20,  // 50 FPS
+        .cls = WS2812_ANIM_HIGH,
+    };
+    ws2812_anim_start(&display_anim);
+
+    LOG_INF("Simple test running - 4 quadrant effects + display on the animation executor!");
+#else
+    for (int q = 0; q < 4; q++) {
+        k_thread_create(&quad_threads[q], quad_stacks[q], K_THREAD_STACK_SIZEOF(quad_stacks[q]),
+                        quad_thread_entry, INT_TO_POINTER(q), NULL, NULL,
+                        quad_priority[q], 0, K_NO_WAIT);
+        k_thread_name_set(&quad_threads[q], quad_names[q]);
+    }
 
     // Create display thread - HIGHEST priority (1) so it always gets to refresh
-    k_thread_create(&display_thread_data, display_stack, 1024,
+    k_thread_create(&display_thread_data, display_stack, K_THREAD_STACK_SIZEOF(display_stack),
                     display_thread_entry, NULL, NULL, NULL,
                     1, 0, K_NO_WAIT);  // Priority 1 - highest, ensures consistent refresh
     k_thread_name_set(&display_thread_data, "display");
 
     LOG_INF("Simple test running - 4 animation threads + 1 display thread!");
+#endif
 }
@@ -3,4 +3,8 @@
 
 void simple_test_init(void);
 
+// Draw one frame of all four quadrants, as the quadrant threads would
+// (used by the benchmark suite; the demo threads must not be running)
+void simple_test_render_frame(void);
+
 #endif
@@ -1,12 +1,34 @@
 #include "ws2812.h"
+#include "ws2812_backend.h"
+#include "ws2812_layer.h"
+#include "ws2812_stats.h"
+#include "ws2812_kernels.h"
 #include <zephyr/device.h>
 #include <zephyr/drivers/spi.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/math_extras.h>
 
 LOG_MODULE_REGISTER(ws2812, LOG_LEVEL_INF);
 
-// LED buffer
-static rgb_t led_buffer[NUM_LEDS];
+// LED buffer, in chain (wire) order
+static rgb_t led_buffer[WS2812_CHAIN_LEN];
+
+// Logical (x, y) -> chain index, generated at build time from the
+// CONFIG_WS2812_MATRIX_* wiring/rotation options and the skipped LED list.
+// -1 marks pixels that land on a skipped (dead) LED.
+static const int16_t xy_map[MATRIX_HEIGHT][MATRIX_WIDTH] = {
+#include "ws2812_xy_map.inc"
+};
+
+// Per logical row: pixel x sits in chain slot start + x * step when the row
+// is one unbroken run (step +1 or -1, e.g. serpentine rows); step 0 means
+// the row crosses a skipped LED or is rotated and goes through xy_map.
+static const struct {
+    int16_t start;
+    int8_t step;
+} row_runs[MATRIX_HEIGHT] = {
+#include "ws2812_row_runs.inc"
+};
 
 // Global brightness control (0-255, where 255 = full brightness)
 static uint8_t global_brightness = 255;  // Start at 25% brightness for testing
@@ -14,34 +36,314 @@ static uint8_t global_brightness = 255;  // Start at 25% brightness for testing
 // Mutex for thread-safe access
 K_MUTEX_DEFINE(matrix_mutex);
 
-// SPI device
-static const struct device *spi_dev;
-static struct spi_config spi_cfg = {
-    .frequency = 6400000,  // 6.4 MHz for WS2812 timing
-    .operation = SPI_WORD_SET(8) | SPI_TRANSFER_MSB | SPI_OP_MODE_MASTER,
-    .slave = 0,
-    .cs = {
-        .gpio = {0},
-        .delay = 0,
+#ifdef CONFIG_WS2812_BACKEND_SPI
+// Output segments: consecutive slices of the LED chain, each with its own
+// data line. They are the strip nodes listed in the zephyr,user
+// "ws2812-segments" property, or just the led-strip alias without it. Every
+// segment but the last is sized by its chain-length; the last one takes the
+// rest of WS2812_CHAIN_LEN.
+struct ws2812_segment {
+    const struct device *bus;
+    const char *name;       // Strip node
+    struct spi_config cfg;
+    uint16_t first;         // First LED of the chain in this segment
+    uint16_t count;
+    size_t offset;          // Start of the segment in each SPI buffer
+    size_t len;             // Lead + LED data + trail bytes
+    uint16_t send;          // LEDs the current frame sends (count unless truncated)
+};
+
+#define SEGMENT_INIT(node)                                                  \
+    {                                                                       \
+        .bus = DEVICE_DT_GET(DT_BUS(node)),                                 \
+        .name = DEVICE_DT_NAME(node),                                       \
+        .cfg = {                                                            \
+            .frequency = CONFIG_WS2812_SPI_FREQ,  /* 6.4 MHz by default */  \
+            .operation = SPI_WORD_SET(8) | SPI_TRANSFER_MSB | SPI_OP_MODE_MASTER, \
+            .slave = DT_REG_ADDR(node),                                     \
+        },                                                                  \
+        .count = DT_PROP(node, chain_length),                               \
     },
+
+#define SEGMENT_INIT_BY_IDX(node_id, prop, idx) SEGMENT_INIT(DT_PHANDLE_BY_IDX(node_id, prop, idx))
+
+static struct ws2812_segment segments[] = {
+#if DT_NODE_HAS_PROP(DT_PATH(zephyr_user), ws2812_segments)
+    DT_FOREACH_PROP_ELEM(DT_PATH(zephyr_user), ws2812_segments, SEGMENT_INIT_BY_IDX)
+#else
+    SEGMENT_INIT(DT_ALIAS(led_strip))
+#endif
+};
+
+#define WS2812_NUM_SEGMENTS ARRAY_SIZE(segments)
+
+// SPI clock the controllers really generate for CONFIG_WS2812_SPI_FREQ
+#if CONFIG_WS2812_SPI_ACTUAL_FREQ > 0
+#define WS2812_SPI_ACTUAL_FREQ CONFIG_WS2812_SPI_ACTUAL_FREQ
+#else
+#define WS2812_SPI_ACTUAL_FREQ CONFIG_WS2812_SPI_FREQ
+#endif
+
+// WS2812 bit patterns using SPI, synthesized in ws2812_init()
+// Each WS2812 bit is enc.symbol_bits SPI bits (high run, then low), so a
+// color byte takes enc.symbol_bits SPI bytes
+static struct ws2812_encoding enc;
+
+// Leading/trailing zero bytes around each segment's LED data (line held LOW)
+#define WS2812_LEAD_BYTES  8
+#define WS2812_TRAIL_BYTES 24
+
+// Async mode double-buffers: the next frame is encoded into one buffer while
+// the other is still on the wire
+#ifdef CONFIG_WS2812_ASYNC
+#define WS2812_NUM_BUFS 2
+#else
+#define WS2812_NUM_BUFS 1
+#endif
+
+#ifdef CONFIG_WS2812_STREAM
+// Streaming: each frame is encoded WS2812_CHUNK_LEDS LEDs at a time into two
+// ping-pong chunk buffers, one on the wire while the next is encoded, so
+// encode RAM does not grow with the chain. The first chunk carries the lead
+// and the last one the trail.
+#define WS2812_CHUNK_LEDS CONFIG_WS2812_STREAM_CHUNK_LEDS
+#define WS2812_NUM_CHUNKS DIV_ROUND_UP(WS2812_CHAIN_LEN, WS2812_CHUNK_LEDS)
+#define WS2812_CHUNK_SIZE                                                   \
+    (WS2812_LEAD_BYTES + WS2812_CHUNK_LEDS * 3 * CONFIG_WS2812_MAX_SYMBOL_BITS + \
+     WS2812_TRAIL_BYTES)
+
+BUILD_ASSERT(ARRAY_SIZE(segments) == 1, "CONFIG_WS2812_STREAM drives a single segment");
+
+static uint8_t chunk_bufs[2][WS2812_CHUNK_SIZE];
+static struct spi_buf chunk_tx_buf[2];
+static struct spi_buf_set chunk_tx[2];
+
+// Given as each chunk leaves the wire
+static K_SEM_DEFINE(chunk_sent, 0, 1);
+
+// Idle time between chunks: the line sits low while the controller is
+// restarted, and the LEDs latch half a frame if it reaches the reset time
+static uint32_t chunk_start_cyc;
+static uint32_t stream_max_gap_cyc;
+static uint32_t stream_underruns;
+#else
+// Only the WS2812_CHAIN_LEN LEDs actually in the chain are sent
+// (255 on the demo panel, whose first LED is bypassed):
+// 255 LEDs * 3 colors * CONFIG_WS2812_MAX_SYMBOL_BITS SPI bytes per color byte
+// (6120 bytes at 8 bits/symbol, 2295 at 3 bits/symbol). Segments follow each
+// other in the buffer, each with its own lead and trail.
+#define WS2812_SPI_BUF_SIZE                                                 \
+    (WS2812_NUM_SEGMENTS * (WS2812_LEAD_BYTES + WS2812_TRAIL_BYTES) +       \
+     WS2812_CHAIN_LEN * 3 * CONFIG_WS2812_MAX_SYMBOL_BITS)
+
+static uint8_t spi_bufs[WS2812_NUM_BUFS][WS2812_SPI_BUF_SIZE];
+static uint8_t back_buf;  // Buffer the next frame is encoded into
+
+#ifdef CONFIG_WS2812_TRUNCATE
+// A truncated frame stops partway through a segment's LED data, so the trail
+// is sent from its own zero buffer as a second piece
+#define WS2812_SEG_PIECES 2
+static uint8_t trail_zeros[WS2812_TRAIL_BYTES];
+#else
+#define WS2812_SEG_PIECES 1
+#endif
+
+// Per buffer and segment; async SPI keeps pointers to these until completion
+static struct spi_buf seg_tx_buf[WS2812_NUM_BUFS][WS2812_NUM_SEGMENTS][WS2812_SEG_PIECES];
+static struct spi_buf_set seg_tx[WS2812_NUM_BUFS][WS2812_NUM_SEGMENTS];
+#endif /* CONFIG_WS2812_STREAM */
+
+#ifdef CONFIG_WS2812_TRUNCATE
+// LEDs keep the color they latched until they receive another, so each
+// frame stops after the last LED that changed. A full frame still goes out
+// every CONFIG_WS2812_TRUNCATE_REFRESH_MS to repair LEDs past the cut that
+// missed or misread an earlier one.
+static uint32_t last_full_ms;
+static uint32_t truncate_frames;
+static uint32_t truncate_refreshes;
+static uint64_t truncate_leds_sent;
+#endif
+#else
+#define WS2812_NUM_BUFS 1
+#endif /* CONFIG_WS2812_BACKEND_SPI */
+
+// Dirty tracking: one bitmap per SPI buffer of LEDs whose encoded slot in
+// that buffer is stale, so only changed LEDs get re-encoded. frame_dirty
+// says whether anything changed since the last transmitted frame.
+#define DIRTY_WORDS DIV_ROUND_UP(WS2812_CHAIN_LEN, 32)
+static uint32_t dirty[WS2812_NUM_BUFS][DIRTY_WORDS];
+static bool frame_dirty = true;
+
+// The reset (latch) gap is enforced from the end-of-transfer timestamp, so
+// the wait only covers whatever part of it hasn't already elapsed
+static volatile uint32_t last_tx_end_cyc;
+
+// Given when no frame is on the wire
+static K_SEM_DEFINE(tx_idle, 1, 1);
+
+// Result of the last frame (first failing segment) and when it started
+static volatile int tx_result;
+static uint32_t tx_start_cyc;
+
+#if defined(CONFIG_WS2812_BACKEND_SPI) && defined(CONFIG_SPI_ASYNC)
+// Segments of the current frame still on the wire
+static atomic_t tx_pending;
+static volatile int tx_error;
+#endif
+
+// 8-bit gamma 2.2 curve, applied after brightness scaling when enabled
+static const uint8_t gamma8[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
 };
 
-// WS2812 bit patterns using SPI
-// At 6.4MHz SPI: each bit is ~156ns
-// WS2812 timing: 0 = 400ns H + 850ns L, 1 = 800ns H + 450ns L
-// Using SPI_MODE_CPOL to invert clock and hopefully MOSI idle state
-#define WS2812_0 0xC0  // Binary: 11000000 (~312ns high, ~938ns low)
-#define WS2812_1 0xF0  // Binary: 11110000 (~625ns high, ~625ns low)
+// Color table: maps an 8-bit channel value to its level after
+// global_brightness and the gamma curve. The SPI backend also keeps each
+// level's SPI bytes in the encode table. Both are rebuilt lazily by
+// ws2812_update() after ws2812_set_brightness()/ws2812_set_gamma().
+static uint8_t color_lut[256];
+#ifdef CONFIG_WS2812_BACKEND_SPI
+static uint8_t encode_lut[256][8];
+#endif
+static bool encode_lut_stale = true;
+static bool gamma_enabled = IS_ENABLED(CONFIG_WS2812_GAMMA);
+
+static inline void mark_dirty(uint16_t index) {
+    for (int b = 0; b < WS2812_NUM_BUFS; b++) {
+        dirty[b][index >> 5] |= BIT(index & 31);
+    }
+    frame_dirty = true;
+}
+
+static void mark_dirty_range(uint16_t first, uint16_t count) {
+    uint16_t last = first + count - 1;
+
+    for (int b = 0; b < WS2812_NUM_BUFS; b++) {
+        for (uint16_t w = first >> 5; w <= last >> 5; w++) {
+            uint32_t mask = UINT32_MAX;
+            if (w == first >> 5) {
+                mask &= UINT32_MAX << (first & 31);
+            }
+            if (w == last >> 5) {
+                mask &= UINT32_MAX >> (31 - (last & 31));
+            }
+            dirty[b][w] |= mask;
+        }
+    }
+    frame_dirty = true;
+}
+
+static void mark_all_dirty(void) {
+    memset(dirty, 0xFF, sizeof(dirty));
+    frame_dirty = true;
+}
+
+#ifdef CONFIG_WS2812_BACKEND_SPI
+// Split the chain over the segments and lay them out in the SPI buffers
+static int segments_init(void) {
+    uint16_t first = 0;
+    size_t offset = 0;
+
+    for (int s = 0; s < WS2812_NUM_SEGMENTS; s++) {
+        struct ws2812_segment *seg = &segments[s];
+
+        if (!device_is_ready(seg->bus)) {
+            LOG_ERR("SPI device %s not ready", seg->bus->name);
+            return -ENODEV;
+        }
+
+        if (s == WS2812_NUM_SEGMENTS - 1) {
+            seg->count = WS2812_CHAIN_LEN - first;
+        } else if (first + seg->count >= WS2812_CHAIN_LEN) {
+            LOG_ERR("Segments before %s already cover the %d LED chain", seg->name,
+                    WS2812_CHAIN_LEN);
+            return -EINVAL;
+        }
+
+        seg->first = first;
+        seg->offset = offset;
+        seg->len = WS2812_LEAD_BYTES + seg->count * 3 * enc.symbol_bits + WS2812_TRAIL_BYTES;
+        seg->send = seg->count;
+        first += seg->count;
+        offset += seg->len;
+
+#ifndef CONFIG_WS2812_STREAM
+        for (int b = 0; b < WS2812_NUM_BUFS; b++) {
+            seg_tx_buf[b][s][0] = (struct spi_buf){ .buf = &spi_bufs[b][seg->offset], .len = seg->len };
+#ifdef CONFIG_WS2812_TRUNCATE
+            seg_tx_buf[b][s][0].len -= WS2812_TRAIL_BYTES;
+            seg_tx_buf[b][s][1] = (struct spi_buf){ .buf = trail_zeros, .len = WS2812_TRAIL_BYTES };
+#endif
+            seg_tx[b][s] = (struct spi_buf_set){ .buffers = seg_tx_buf[b][s],
+                                                 .count = WS2812_SEG_PIECES };
+        }
+#endif
+
+        LOG_INF("Segment %d: LEDs %u-%u on %s", s, seg->first, seg->first + seg->count - 1,
+                seg->bus->name);
+    }
+    return 0;
+}
+
+static int spi_backend_init(void) {
+    int ret = ws2812_encoding_synthesize(WS2812_SPI_ACTUAL_FREQ, CONFIG_WS2812_MAX_SYMBOL_BITS,
+                                         &ws2812_default_timing, &enc);
+    if (ret < 0) {
+        LOG_ERR("No WS2812 encoding fits %u Hz SPI within %d bits/symbol",
+                WS2812_SPI_ACTUAL_FREQ, CONFIG_WS2812_MAX_SYMBOL_BITS);
+        return ret;
+    }
+
+    // The SPI controllers the strip nodes sit on (SERCOM4 on the SAM E54,
+    // emulated controllers on native_sim)
+    ret = segments_init();
+    if (ret < 0) {
+        return ret;
+    }
+
+#ifdef CONFIG_WS2812_STREAM
+    for (int b = 0; b < 2; b++) {
+        chunk_tx_buf[b].buf = chunk_bufs[b];
+        chunk_tx[b] = (struct spi_buf_set){ .buffers = &chunk_tx_buf[b], .count = 1 };
+    }
+    LOG_INF("Streaming %d chunks of %d LEDs (2 x %d bytes)", WS2812_NUM_CHUNKS,
+            WS2812_CHUNK_LEDS, WS2812_CHUNK_SIZE);
+#else
+    // Lead/trail zeros are written once; LED slots are kept current by the dirty bitmaps
+    memset(spi_bufs, 0, sizeof(spi_bufs));
+#endif
+
+    LOG_INF("Direct SPI on %d segment(s)", (int)WS2812_NUM_SEGMENTS);
+    LOG_INF("Encoding: %u Hz, %u SPI bits/bit, T0H=%uns T1H=%uns period=%uns margin=%uns",
+            enc.spi_hz, enc.symbol_bits, enc.t0h_ns, enc.t1h_ns, enc.period_ns, enc.margin_ns);
+    return 0;
+}
+#endif /* CONFIG_WS2812_BACKEND_SPI */
 
 int ws2812_init(void) {
-    spi_dev = DEVICE_DT_GET(DT_NODELABEL(sercom4));
+    int ret = ws2812_backend.init();
 
-    if (!device_is_ready(spi_dev)) {
-        LOG_ERR("SPI device not ready");
-        return -ENODEV;
+    if (ret < 0) {
+        return ret;
     }
+    encode_lut_stale = true;
+    mark_all_dirty();
 
-    LOG_INF("WS2812 driver initialized on SERCOM4 - Direct SPI");
+    LOG_INF("WS2812 driver initialized - %s backend", ws2812_backend.name);
 
     ws2812_clear();
     ws2812_update();
@@ -51,34 +353,14 @@ int ws2812_init(void) {
 void ws2812_set_pixel(uint8_t x, uint8_t y, rgb_t color) {
     if (x >= MATRIX_WIDTH || y >= MATRIX_HEIGHT) return;
 
-    // Convert x,y to linear index
-    // Assumes zigzag wiring pattern - adjust based on your matrix
-    uint16_t index;
-    if (y % 2 == 0) {
-        // Even rows: left to right
-        index = y * MATRIX_WIDTH + x;
-    } else {
-        // Odd rows: right to left (zigzag)
-        index = y * MATRIX_WIDTH + (MATRIX_WIDTH - 1 - x);
-    }
-
-    // Compensate for bad LED at position 0 by shifting left
-    // Physical LED 0 is bad, so we skip it: write to index-1 in buffer
-    // This way: buffer[0]→LED 1, buffer[1]→LED 2, etc.
-    if (index > 0) {
-        index = index - 1;
-    } else {
-        // index 0 would go to bad LED, skip it
-        return;
-    }
+    int16_t index = xy_map[y][x];
+    if (index < 0) return;  // Lands on a skipped LED
 
-    // Safety check - with shift, we can only address NUM_LEDS-1
-    if(index >= NUM_LEDS - 1) {
-        LOG_WRN("Pixel write overflow: x=%d, y=%d, index=%d (limit=%d)", x, y, index, NUM_LEDS-1);
-        return;
+    if (led_buffer[index].g != color.g || led_buffer[index].r != color.r ||
+        led_buffer[index].b != color.b) {
+        led_buffer[index] = color;
+        mark_dirty(index);
     }
-
-    led_buffer[index] = color;
 }
 
 rgb_t ws2812_get_pixel(uint8_t x, uint8_t y) {
@@ -86,92 +368,719 @@ rgb_t ws2812_get_pixel(uint8_t x, uint8_t y) {
         return (rgb_t){0, 0, 0};
     }
 
-    uint16_t index;
-    if (y % 2 == 0) {
-        index = y * MATRIX_WIDTH + x;
-    } else {
-        index = y * MATRIX_WIDTH + (MATRIX_WIDTH - 1 - x);
+    int16_t index = xy_map[y][x];
+    if (index < 0) {
+        return (rgb_t){0, 0, 0};
     }
 
-    // Apply same shift as set_pixel
-    if (index > 0) {
-        index = index - 1;
-    } else {
-        return (rgb_t){0, 0, 0};
+    return led_buffer[index];
+}
+
+int ws2812_chain_index(int x, int y) {
+    if (x < 0 || x >= MATRIX_WIDTH || y < 0 || y >= MATRIX_HEIGHT) {
+        return -1;
     }
+    return xy_map[y][x];
+}
 
-    if(index >= NUM_LEDS) return (rgb_t){0, 0, 0};
+// Clip the rectangle (x, y, w, h) to the matrix. src_x/src_y receive how far
+// the visible part starts inside the rectangle. Returns false if nothing is
+// left to draw.
+static bool clip_rect(int *x, int *y, int *w, int *h, int *src_x, int *src_y) {
+    *src_x = (*x < 0) ? -*x : 0;
+    *src_y = (*y < 0) ? -*y : 0;
+    *x += *src_x;
+    *y += *src_y;
+    *w = MIN(*w - *src_x, MATRIX_WIDTH - *x);
+    *h = MIN(*h - *src_y, MATRIX_HEIGHT - *y);
+    return *w > 0 && *h > 0;
+}
 
-    return led_buffer[index];
+// Copy len pixels into consecutive chain slots from first on, marking only
+// the span between the first and last changed LED dirty
+static void write_chain_run(int first, int len, const rgb_t *src, int src_step) {
+    rgb_t *dst = &led_buffer[first];
+    int lo = -1, hi = 0;
+
+    for (int i = 0; i < len; i++, src += src_step) {
+        if (dst[i].g != src->g || dst[i].r != src->r || dst[i].b != src->b) {
+            dst[i] = *src;
+            if (lo < 0) {
+                lo = i;
+            }
+            hi = i;
+        }
+    }
+    if (lo >= 0) {
+        mark_dirty_range(first + lo, hi - lo + 1);
+    }
+}
+
+// Write len pixels of row y starting at column x (already clipped). src
+// advances by src_step per pixel (0 for a solid color). Rows that are one
+// unbroken run are written in ascending chain order, reversing the source
+// for right-to-left rows, and only the changed span is marked dirty.
+static void write_row_clipped(int x, int y, int len, const rgb_t *src, int src_step) {
+    int8_t step = row_runs[y].step;
+
+    if (step == 0) {
+        for (int i = 0; i < len; i++, src += src_step) {
+            ws2812_set_pixel(x + i, y, *src);
+        }
+        return;
+    }
+
+    int first = row_runs[y].start + x * step;
+    if (step < 0) {
+        first -= len - 1;
+        src += (len - 1) * src_step;
+        src_step = -src_step;
+    }
+
+    write_chain_run(first, len, src, src_step);
+}
+
+void ws2812_fill_rect(int x, int y, int w, int h, rgb_t color) {
+    int sx, sy;
+
+    if (!clip_rect(&x, &y, &w, &h, &sx, &sy)) return;
+
+    for (int row = y; row < y + h; row++) {
+        write_row_clipped(x, row, w, &color, 0);
+    }
+}
+
+void ws2812_fill(rgb_t color) {
+    // Every chain LED is a pixel, so the whole buffer is one run
+    write_chain_run(0, WS2812_CHAIN_LEN, &color, 0);
+}
+
+void ws2812_write_row(int x, int y, const rgb_t *pixels, int len) {
+    int sx, sy, h = 1;
+
+    if (!clip_rect(&x, &y, &len, &h, &sx, &sy)) return;
+
+    write_row_clipped(x, y, len, pixels + sx, 1);
+}
+
+void ws2812_blit(int x, int y, int w, int h, const rgb_t *sprite) {
+    int sx, sy;
+    const int stride = w;
+
+    if (!clip_rect(&x, &y, &w, &h, &sx, &sy)) return;
+
+    const rgb_t *src = sprite + sy * stride + sx;
+    for (int row = y; row < y + h; row++, src += stride) {
+        write_row_clipped(x, row, w, src, 1);
+    }
+}
+
+void ws2812_fade(uint8_t scale) {
+    ws2812_kernel_fade(led_buffer, WS2812_CHAIN_LEN, scale);
+    mark_all_dirty();
 }
 
 void ws2812_clear(void) {
-    memset(led_buffer, 0, sizeof(led_buffer));
+    for (int i = 0; i < WS2812_CHAIN_LEN; i++) {
+        if (led_buffer[i].g | led_buffer[i].r | led_buffer[i].b) {
+            led_buffer[i] = (rgb_t){0, 0, 0};
+            mark_dirty(i);
+        }
+    }
 }
 
-void ws2812_update(void) {
-    // Each WS2812 color byte (8 bits) becomes 8 SPI bytes
-    // Since we shift left by 1, we only use NUM_LEDS-1 actual LEDs (255 LEDs)
-    // 255 LEDs * 3 colors * 8 SPI bytes per color byte = 6120 bytes
-    // Add leading zeros to force line LOW and ensure proper alignment
-    // Add trailing zeros at the end to ensure line idles LOW during reset
-    static uint8_t spi_buf[24 + (NUM_LEDS - 1) * 3 * 8 + 8];  // +24 leading zeros
-    uint16_t spi_idx = 0;
-
-  // Add trailing zeros to force line LOW during reset
-    for (int i = 0; i < 8; i++) {
-        spi_buf[spi_idx++] = 0x00;
-    }
-    // Convert RGB buffer to SPI timing pattern
-    // Note: Bad LED compensation is now handled in ws2812_set_pixel() by shifting left when writing
-    // Since we shift left, the last LED (index NUM_LEDS-1) is never written to, so only send NUM_LEDS-1
-    for (int i = 0; i < NUM_LEDS - 1; i++) {
-        // Compensate for byte-level shift: rotate color order by sending GRB instead of BGR
-        // This compensates for the SPI idle-high causing a bit/byte shift at second LED
-        uint8_t colors[3] = {
-            (led_buffer[i].g * global_brightness) / 255,  // G first (was B)
-            (led_buffer[i].r * global_brightness) / 255,  // R second (was G)
-            (led_buffer[i].b * global_brightness) / 255   // B third (was R)
-        };
-
-        LOG_DBG("LED %d: B=%d G=%d R=%d", i, colors[0], colors[1], colors[2]);
-
-        // Convert each color byte to SPI bits
-        for (int c = 0; c < 3; c++) {
-            for (int bit = 7; bit >= 0; bit--) {
-                spi_buf[spi_idx++] = (colors[c] & (1 << bit)) ? WS2812_1 : WS2812_0;
+void ws2812_invalidate(void) {
+    mark_all_dirty();
+}
+
+static void encode_lut_rebuild(void) {
+    for (int v = 0; v < 256; v++) {
+        uint8_t level = (v * global_brightness) / 255;
+        if (gamma_enabled) {
+            level = gamma8[level];
+        }
+        color_lut[v] = level;
+
+#ifdef CONFIG_WS2812_BACKEND_SPI
+        // Concatenate 8 symbols MSB first: 8 * symbol_bits bits = symbol_bits bytes
+        uint64_t stream = 0;
+        for (int bit = 7; bit >= 0; bit--) {
+            stream = (stream << enc.symbol_bits) |
+                     ((level & (1 << bit)) ? enc.one_symbol : enc.zero_symbol);
+        }
+        for (int k = 0; k < enc.symbol_bits; k++) {
+            encode_lut[v][k] = (uint8_t)(stream >> (8 * (enc.symbol_bits - 1 - k)));
+        }
+#endif
+    }
+    encode_lut_stale = false;
+}
+
+#ifdef CONFIG_WS2812_BACKEND_SPI
+// Encode count LEDs starting at first into their slots of spi_buf.
+// Channels are written with a fixed 8-byte table copy, of which only the
+// first symbol_bits bytes are kept; the spill is overwritten by the next
+// channel. The last LED of the span gets exact-size copies so it can't
+// clobber a clean LED that follows.
+static void encode_span(uint8_t *out, uint16_t first, uint16_t count) {
+    const uint8_t n = enc.symbol_bits;
+    const rgb_t *led = &led_buffer[first];
+
+    // Compensate for byte-level shift: rotate color order by sending GRB instead of BGR
+    // This compensates for the SPI idle-high causing a bit/byte shift at second LED
+    for (uint16_t i = 0; i < count - 1; i++, led++) {
+        memcpy(out, encode_lut[led->g], 8);
+        memcpy(out + n, encode_lut[led->r], 8);
+        memcpy(out + 2 * n, encode_lut[led->b], 8);
+        out += 3 * n;
+    }
+    memcpy(out, encode_lut[led->g], n);
+    memcpy(out + n, encode_lut[led->r], n);
+    memcpy(out + 2 * n, encode_lut[led->b], n);
+}
+
+#ifndef CONFIG_WS2812_STREAM
+// Bring spi_bufs[b] up to date with led_buffer by re-encoding only the runs
+// of LEDs marked in dirty[b]. The caller rebuilds a stale encode_lut first.
+static void encode_frame(uint8_t b) {
+    uint8_t *spi_buf = spi_bufs[b];
+    uint32_t *bits = dirty[b];
+
+    // Note: Skipped/bad LEDs are already folded into xy_map, led_buffer is in chain order.
+    // Runs never cross a segment boundary: the next segment's slots don't follow on.
+    for (int s = 0; s < WS2812_NUM_SEGMENTS; s++) {
+        const struct ws2812_segment *seg = &segments[s];
+        uint8_t *seg_buf = &spi_buf[seg->offset + WS2812_LEAD_BYTES];
+        uint16_t end = seg->first + seg->count;
+        uint16_t i = seg->first;
+
+        while (i < end) {
+            uint32_t word = bits[i >> 5] >> (i & 31);
+            if (word == 0) {
+                i = (i | 31) + 1;
+                continue;
+            }
+            i += u32_count_trailing_zeros(word);
+            if (i >= end) {
+                break;
+            }
+
+            uint16_t start = i;
+            while (i < end && (bits[i >> 5] & BIT(i & 31))) {
+                i++;
             }
+            encode_span(&seg_buf[(start - seg->first) * 3 * enc.symbol_bits], start, i - start);
+        }
+    }
+    memset(bits, 0, sizeof(dirty[b]));
+}
+#endif
+
+#ifdef CONFIG_WS2812_TRUNCATE
+// Highest LED in [first, end) marked in bits, or first - 1 if there is none
+static int last_marked(const uint32_t *bits, int first, int end) {
+    int i = end - 1;
+
+    while (i >= first) {
+        uint32_t word = bits[i >> 5] & (UINT32_MAX >> (31 - (i & 31)));
+
+        if (word) {
+            return MAX((i | 31) - u32_count_leading_zeros(word), first - 1);
         }
+        i = (i & ~31) - 1;
     }
+    return first - 1;
+}
+
+// Set how many LEDs of each segment the next frame sends: all of them when
+// full, else up to the last one marked in bits (which must cover every LED
+// changed since the last frame). Segments with nothing to send are skipped.
+static void truncate_plan(const uint32_t *bits, bool full) {
+    bool whole = true;
+
+    for (int s = 0; s < WS2812_NUM_SEGMENTS; s++) {
+        struct ws2812_segment *seg = &segments[s];
 
-    // Add trailing zeros to force line LOW during reset
-    for (int i = 0; i < 8; i++) {
-        spi_buf[spi_idx++] = 0x00;
+        seg->send = full ? seg->count
+                         : last_marked(bits, seg->first, seg->first + seg->count) + 1 - seg->first;
+        truncate_leds_sent += seg->send;
+        whole &= seg->send == seg->count;
     }
+    truncate_frames++;
+    // A frame that happens to reach the end of every segment refreshes the
+    // whole chain as well as a forced one, so the refresh period restarts
+    if (whole) {
+        last_full_ms = k_uptime_get_32();
+        truncate_refreshes++;
+    }
+}
 
-    // Send via SPI
-    const struct spi_buf tx_buf = {
-        .buf = spi_buf,
-        .len = sizeof(spi_buf)
+void ws2812_truncate_get_info(struct ws2812_truncate_info *info) {
+    *info = (struct ws2812_truncate_info){
+        .frames = truncate_frames,
+        .full_frames = truncate_refreshes,
+        .leds_sent = truncate_leds_sent,
+        .refresh_ms = CONFIG_WS2812_TRUNCATE_REFRESH_MS,
     };
-    const struct spi_buf_set tx = {
-        .buffers = &tx_buf,
-        .count = 1
+}
+#endif
+
+#endif /* CONFIG_WS2812_BACKEND_SPI */
+
+void ws2812_get_ram_info(struct ws2812_ram_info *info) {
+    *info = (struct ws2812_ram_info){
+        .framebuffer = sizeof(led_buffer),
+        .tables = sizeof(color_lut) + sizeof(dirty),
     };
 
-    int ret = spi_write(spi_dev, &spi_cfg, &tx);
-    if (ret < 0) {
-        LOG_ERR("SPI write failed: %d", ret);
-    } else {
-        LOG_DBG("SPI write OK - sent %d bytes", sizeof(spi_buf));
+#ifdef CONFIG_WS2812_BACKEND_SPI
+    info->tables += sizeof(encode_lut);
+    info->symbol_bits = enc.symbol_bits;
+#ifdef CONFIG_WS2812_STREAM
+    info->spi_bufs = sizeof(chunk_bufs);
+    info->spi_bufs_used = ARRAY_SIZE(chunk_bufs) *
+        (WS2812_LEAD_BYTES + WS2812_CHUNK_LEDS * 3 * enc.symbol_bits + WS2812_TRAIL_BYTES);
+#else
+    info->spi_bufs = sizeof(spi_bufs);
+    for (int s = 0; s < WS2812_NUM_SEGMENTS; s++) {
+        info->spi_bufs_used += WS2812_NUM_BUFS * segments[s].len;
+    }
+#endif
+#endif
+}
+
+static void wait_reset_gap(void) {
+    uint32_t elapsed = k_cycle_get_32() - last_tx_end_cyc;
+    uint32_t gap = k_us_to_cyc_ceil32(CONFIG_WS2812_RESET_US);
+
+    if (elapsed < gap) {
+        k_busy_wait(k_cyc_to_us_ceil32(gap - elapsed));
+    }
+}
+
+// The last segment of a frame is done (thread or ISR context)
+void ws2812_backend_done(int result) {
+    last_tx_end_cyc = k_cycle_get_32();
+    tx_result = result;
+    ws2812_stats_lap(WS2812_STAT_TRANSFER, tx_start_cyc);
+    if (result < 0) {
+        ws2812_stats_error();
+    }
+    k_sem_give(&tx_idle);
+}
+
+#ifdef CONFIG_WS2812_BACKEND_SPI
+#ifdef CONFIG_SPI_ASYNC
+static void segment_done(const struct device *dev, int result, void *data) {
+    if (result < 0) {
+        tx_error = result;
+    }
+    if (atomic_dec(&tx_pending) == 1) {
+        ws2812_backend_done(tx_error);
+    }
+}
+#endif
+
+#ifdef CONFIG_WS2812_STREAM
+// Encode chunk k of a frame of the first leds LEDs into chunk_bufs[k & 1];
+// returns its length
+static size_t encode_chunk(int k, uint16_t leds) {
+    uint8_t *out = chunk_bufs[k & 1];
+    uint16_t first = k * WS2812_CHUNK_LEDS;
+    uint16_t count = MIN(WS2812_CHUNK_LEDS, leds - first);
+    size_t len = 0;
+
+    if (k == 0) {
+        memset(out, 0, WS2812_LEAD_BYTES);
+        len = WS2812_LEAD_BYTES;
+    }
+    encode_span(&out[len], first, count);
+    len += count * 3 * enc.symbol_bits;
+    if (first + count == leds) {
+        memset(&out[len], 0, WS2812_TRAIL_BYTES);
+        len += WS2812_TRAIL_BYTES;
+    }
+    return len;
+}
+
+static void chunk_done(const struct device *dev, int result, void *data) {
+    if (result < 0) {
+        tx_error = result;
+    }
+    last_tx_end_cyc = k_cycle_get_32();
+    k_sem_give(&chunk_sent);
+}
+
+// Put len bytes of chunk_bufs[b] on the wire; chunk_done() runs once they are out
+static void start_chunk(uint8_t b, size_t len) {
+    const struct ws2812_segment *seg = &segments[0];
+    int ret;
+
+    chunk_tx_buf[b].len = len;
+    chunk_start_cyc = k_cycle_get_32();
+    ret = spi_transceive_cb(seg->bus, &seg->cfg, &chunk_tx[b], NULL, chunk_done, NULL);
+    if (ret == -ENOTSUP) {
+        // Controller without async support: send the chunk in place
+        ret = spi_write(seg->bus, &seg->cfg, &chunk_tx[b]);
+        chunk_done(seg->bus, ret, NULL);
+    } else if (ret < 0) {
+        chunk_done(seg->bus, ret, NULL);
     }
+}
+
+// Encode and send the first leds LEDs of the chain, chunk k being encoded
+// while chunk k-1 is on the wire. Call with tx_idle taken; ws2812_backend_done()
+// gives it back.
+static void stream_frame(uint16_t leds) {
+    const uint32_t reset_cyc = k_us_to_cyc_ceil32(CONFIG_WS2812_RESET_US);
+    const int chunks = DIV_ROUND_UP(leds, WS2812_CHUNK_LEDS);
+
+    tx_error = 0;
+    if (chunks == 0) {
+        ws2812_backend_done(0);
+        return;
+    }
+    start_chunk(0, encode_chunk(0, leds));
+
+    for (int k = 1; k < chunks; k++) {
+        size_t len = encode_chunk(k, leds);
+
+        k_sem_take(&chunk_sent, K_FOREVER);
+        start_chunk(k & 1, len);
+
+        // Gap between the end of chunk k-1 and the start of chunk k
+        uint32_t gap = chunk_start_cyc - last_tx_end_cyc;
+        if ((int32_t)gap > 0) {
+            stream_max_gap_cyc = MAX(stream_max_gap_cyc, gap);
+            stream_underruns += gap >= reset_cyc;
+        }
+    }
+
+    k_sem_take(&chunk_sent, K_FOREVER);
+    ws2812_backend_done(tx_error);
+}
+
+void ws2812_stream_get_info(struct ws2812_stream_info *info) {
+    *info = (struct ws2812_stream_info){
+        .chunk_leds = WS2812_CHUNK_LEDS,
+        .chunks = WS2812_NUM_CHUNKS,
+        .chunk_bytes = WS2812_CHUNK_SIZE,
+        .chunk_wire_ns = (uint64_t)WS2812_CHUNK_LEDS * 24 * enc.symbol_bits * NSEC_PER_SEC /
+                         enc.spi_hz,
+        .max_gap_ns = k_cyc_to_ns_floor64(stream_max_gap_cyc),
+        .underruns = stream_underruns,
+    };
+}
+
+#ifdef CONFIG_WS2812_BENCH_SUITE
+void ws2812_bench_stream_chunk(int k) {
+    if (encode_lut_stale) {
+        encode_lut_rebuild();
+    }
+    encode_chunk(k % WS2812_NUM_CHUNKS, WS2812_CHAIN_LEN);
+}
+#endif
+
+#else /* !CONFIG_WS2812_STREAM */
+
+// Point each segment's LED data piece at the seg->send LEDs it sends;
+// returns the number of segments with anything to send
+static int frame_segments(uint8_t b) {
+    int num = 0;
 
-    // WS2812 needs >50us reset time (line will idle at last bit = 0)
-    k_usleep(60);
-    
+    for (int s = 0; s < WS2812_NUM_SEGMENTS; s++) {
+        const struct ws2812_segment *seg = &segments[s];
+
+#ifdef CONFIG_WS2812_TRUNCATE
+        seg_tx_buf[b][s][0].len = WS2812_LEAD_BYTES + seg->send * 3 * enc.symbol_bits;
+#endif
+        num += seg->send > 0;
+    }
+    return num;
 }
 
+// Send spi_bufs[b] down every segment. With SPI_ASYNC all transfers start
+// back to back, so a frame takes as long as its longest segment rather
+// than the sum. Call with tx_idle taken; ws2812_backend_done() gives it back.
+static void start_frame(uint8_t b) {
+#ifdef CONFIG_SPI_ASYNC
+    int num = frame_segments(b);
+
+    tx_error = 0;
+    atomic_set(&tx_pending, num);
+    if (num == 0) {
+        ws2812_backend_done(0);
+        return;
+    }
+
+    for (int s = 0; s < WS2812_NUM_SEGMENTS; s++) {
+        const struct ws2812_segment *seg = &segments[s];
+        if (seg->send == 0) {
+            continue;
+        }
+
+        int ret = spi_transceive_cb(seg->bus, &seg->cfg, &seg_tx[b][s], NULL, segment_done, NULL);
+
+        if (ret == -ENOTSUP) {
+            // Controller without async support: send this segment in place
+            ret = spi_write(seg->bus, &seg->cfg, &seg_tx[b][s]);
+            segment_done(seg->bus, ret, NULL);
+        } else if (ret < 0) {
+            // Never started, so no callback will come
+            segment_done(seg->bus, ret, NULL);
+        }
+    }
+#else
+    int result = 0;
+
+    frame_segments(b);
+    for (int s = 0; s < WS2812_NUM_SEGMENTS; s++) {
+        const struct ws2812_segment *seg = &segments[s];
+        if (seg->send == 0) {
+            continue;
+        }
+
+        int ret = spi_write(seg->bus, &seg->cfg, &seg_tx[b][s]);
+
+        if (ret < 0) {
+            result = ret;
+        }
+    }
+    ws2812_backend_done(result);
+#endif
+}
+#endif /* CONFIG_WS2812_STREAM */
+
+static void spi_backend_encode(const rgb_t *leds, const uint8_t *lut) {
+#ifdef CONFIG_WS2812_STREAM
+    // Chunks are encoded while the frame goes out, within the transfer
+    // time; the dirty bits only matter to truncation
+    memset(dirty, 0, sizeof(dirty));
+#else
+    // In async mode, encode while the previous frame may still be on the wire
+    encode_frame(back_buf);
+#endif
+}
+
+static void spi_backend_start(void) {
+#if defined(CONFIG_WS2812_STREAM)
+    // Returns once the last chunk is out
+    stream_frame(segments[0].send);
+#elif defined(CONFIG_WS2812_ASYNC)
+    start_frame(back_buf);
+    back_buf ^= 1;
+#else
+    start_frame(back_buf);
+#endif
+}
+
+// Segments are sent side by side with SPI_ASYNC, else one after the other
+static uint32_t spi_backend_frame_ns(void) {
+    uint64_t bits = 0;
+
+    for (int s = 0; s < WS2812_NUM_SEGMENTS; s++) {
+        uint64_t seg_bits = segments[s].len * 8;
+
+        bits = IS_ENABLED(CONFIG_SPI_ASYNC) ? MAX(bits, seg_bits) : bits + seg_bits;
+    }
+    return bits * NSEC_PER_SEC / enc.spi_hz;
+}
+
+const struct ws2812_backend ws2812_backend = {
+    .name = IS_ENABLED(CONFIG_WS2812_STREAM) ? "spi-stream" :
+            IS_ENABLED(CONFIG_WS2812_ASYNC)  ? "spi-dma" : "spi",
+    .init = spi_backend_init,
+    .encode = spi_backend_encode,
+    .start = spi_backend_start,
+    .frame_ns = spi_backend_frame_ns,
+    .async = IS_ENABLED(CONFIG_WS2812_ASYNC),
+};
+#endif /* CONFIG_WS2812_BACKEND_SPI */
+
+void ws2812_update(void) {
+#ifdef CONFIG_WS2812_LAYERS
+    ws2812_layers_compose();
+#endif
+
+    bool refresh = false;
+#ifdef CONFIG_WS2812_TRUNCATE
+    uint32_t period_ms = CONFIG_WS2812_TRUNCATE_REFRESH_MS;
+
+    refresh = period_ms > 0 && k_uptime_get_32() - last_full_ms >= period_ms;
+#endif
+
+    // Nothing changed since the last frame and it went out: the LEDs
+    // already show it
+    if (!frame_dirty && !encode_lut_stale && !refresh && tx_result >= 0) {
+        ws2812_stats_frame_skipped();
+        return;
+    }
+
+    uint32_t t = ws2812_stats_now();
+#ifdef CONFIG_WS2812_TRUNCATE
+    // New brightness or gamma changes every LED. Read the dirty bits before
+    // encoding clears them.
+#ifdef CONFIG_WS2812_STREAM
+    truncate_plan(dirty[0], refresh || encode_lut_stale);
+#else
+    truncate_plan(dirty[back_buf], refresh || encode_lut_stale);
+#endif
+#endif
+    if (encode_lut_stale) {
+        encode_lut_rebuild();
+        mark_all_dirty();
+    }
+    ws2812_backend.encode(led_buffer, color_lut);
+    t = ws2812_stats_lap(WS2812_STAT_ENCODE, t);
+    frame_dirty = false;
+
+    k_sem_take(&tx_idle, K_FOREVER);
+    if (ws2812_backend.async) {
+        if (tx_result < 0) {
+            LOG_ERR("Frame output failed: %d", tx_result);
+#ifdef CONFIG_WS2812_TRUNCATE
+            // This frame, already planned, may stop short of LEDs that
+            // missed the failed one: send the next one whole
+            mark_all_dirty();
+#endif
+        }
+        t = ws2812_stats_lap(WS2812_STAT_TX_WAIT, t);
+    }
+
+    // WS2812 needs >50us reset time (line idles at last bit = 0)
+    wait_reset_gap();
+    t = ws2812_stats_lap(WS2812_STAT_RESET_WAIT, t);
+
+    tx_start_cyc = t;
+    ws2812_stats_frame_sent(t);
+    ws2812_backend.start();
+    if (!ws2812_backend.async) {
+        // Blocking backends are done once the frame is out
+        ws2812_sync();
+        if (tx_result < 0) {
+            // Send the whole frame again on the next update
+            LOG_ERR("Frame output failed: %d", tx_result);
+            mark_all_dirty();
+        }
+    }
+}
+
+void ws2812_sync(void) {
+    k_sem_take(&tx_idle, K_FOREVER);
+    k_sem_give(&tx_idle);
+}
+
+#ifdef CONFIG_WS2812_BENCH
+// Original per-bit encoder (generalized to the synthesized symbol width),
+// kept only as the baseline for ws2812_bench_encode()
+static void encode_frame_reference(uint8_t *spi_buf) {
+    uint32_t spi_idx = 0;
+    uint32_t acc = 0;
+    int acc_bits = 0;
+
+    for (int s = 0; s < WS2812_NUM_SEGMENTS; s++) {
+        for (int i = 0; i < WS2812_LEAD_BYTES; i++) {
+            spi_buf[spi_idx++] = 0x00;
+        }
+        for (int i = segments[s].first; i < segments[s].first + segments[s].count; i++) {
+            uint8_t colors[3] = {
+                (led_buffer[i].g * global_brightness) / 255,
+                (led_buffer[i].r * global_brightness) / 255,
+                (led_buffer[i].b * global_brightness) / 255
+            };
+
+            for (int c = 0; c < 3; c++) {
+                if (gamma_enabled) {
+                    colors[c] = gamma8[colors[c]];
+                }
+                for (int bit = 7; bit >= 0; bit--) {
+                    acc = (acc << enc.symbol_bits) |
+                          ((colors[c] & (1 << bit)) ? enc.one_symbol : enc.zero_symbol);
+                    acc_bits += enc.symbol_bits;
+                    if (acc_bits >= 8) {
+                        acc_bits -= 8;
+                        spi_buf[spi_idx++] = (uint8_t)(acc >> acc_bits);
+                    }
+                }
+            }
+        }
+        for (int i = 0; i < WS2812_TRAIL_BYTES; i++) {
+            spi_buf[spi_idx++] = 0x00;
+        }
+    }
+}
+
+void ws2812_bench_encode(struct ws2812_bench_result *res) {
+    uint8_t *spi_buf = spi_bufs[back_buf];
+    uint32_t start;
+
+    // Don't scribble over a buffer that may still be on the wire
+    ws2812_sync();
+
+    start = k_cycle_get_32();
+    encode_lut_rebuild();
+    res->lut_build_cycles = k_cycle_get_32() - start;
+
+    start = k_cycle_get_32();
+    encode_frame_reference(spi_buf);
+    res->reference_cycles = k_cycle_get_32() - start;
+
+    // Full re-encode, as if every LED changed
+    memset(dirty[back_buf], 0xFF, sizeof(dirty[back_buf]));
+    start = k_cycle_get_32();
+    encode_frame(back_buf);
+    res->lut_cycles = k_cycle_get_32() - start;
+
+    // Typical animation frame: a 2x2 ball moved in each quadrant (16 LEDs + 16 erased)
+    for (int k = 0; k < 32; k++) {
+        uint16_t index = (k * 97) % WS2812_CHAIN_LEN;
+        dirty[back_buf][index >> 5] |= BIT(index & 31);
+    }
+    start = k_cycle_get_32();
+    encode_frame(back_buf);
+    res->incremental_cycles = k_cycle_get_32() - start;
+}
+#endif
 
 void ws2812_set_brightness(uint8_t brightness) {
-    global_brightness = brightness;
+    if (brightness != global_brightness) {
+        global_brightness = brightness;
+        encode_lut_stale = true;
+    }
+}
+
+#ifdef CONFIG_WS2812_BACKEND_SPI
+const struct ws2812_encoding *ws2812_get_encoding(void) {
+    return &enc;
+}
+
+int ws2812_num_segments(void) {
+    return WS2812_NUM_SEGMENTS;
+}
+
+int ws2812_get_segment(int s, struct ws2812_segment_info *info) {
+    if (s < 0 || s >= WS2812_NUM_SEGMENTS) {
+        return -EINVAL;
+    }
+
+    *info = (struct ws2812_segment_info){
+        .name = segments[s].name,
+        .bus = segments[s].bus,
+        .first = segments[s].first,
+        .count = segments[s].count,
+        .len = segments[s].len,
+    };
+    return 0;
+}
+#endif
+
+void ws2812_set_gamma(bool enable) {
+    if (enable != gamma_enabled) {
+        gamma_enabled = enable;
+        encode_lut_stale = true;
+    }
+}
+
+bool ws2812_get_gamma(void) {
+    return gamma_enabled;
 }
@@ -2,9 +2,11 @@
 #define WS2812_H
 
 #include <zephyr/kernel.h>
+#include "ws2812_timing.h"
+#include "ws2812_geometry.h"  // Generated: WS2812_CHAIN_LEN, panel size
 
-#define MATRIX_WIDTH  16
-#define MATRIX_HEIGHT 16
+#define MATRIX_WIDTH  CONFIG_WS2812_MATRIX_WIDTH
+#define MATRIX_HEIGHT CONFIG_WS2812_MATRIX_HEIGHT
 #define NUM_LEDS (MATRIX_WIDTH * MATRIX_HEIGHT)
 
 typedef struct {
@@ -22,15 +24,134 @@ void ws2812_set_pixel(uint8_t x, uint8_t y, rgb_t color);
 // Get pixel color
 rgb_t ws2812_get_pixel(uint8_t x, uint8_t y);
 
+// Position of pixel (x, y) in the LED chain, or -1 if it is off the
+// matrix or lands on a skipped LED
+int ws2812_chain_index(int x, int y);
+
 // Clear all pixels
 void ws2812_clear(void);
 
+// Bulk drawing: each call clips once, then writes whole rows in wire order.
+// Coordinates may be negative or extend past the matrix edge.
+
+// Fill every pixel with one color
+void ws2812_fill(rgb_t color);
+
+// Fill a w x h rectangle whose top-left corner is (x, y)
+void ws2812_fill_rect(int x, int y, int w, int h, rgb_t color);
+
+// Write len pixels to row y, starting at column x
+void ws2812_write_row(int x, int y, const rgb_t *pixels, int len);
+
+// Draw a w x h sprite (row-major, w pixels per row) with its top-left at (x, y)
+void ws2812_blit(int x, int y, int w, int h, const rgb_t *sprite);
+
+// Scale every channel of the whole framebuffer by scale/256 (a fade step)
+void ws2812_fade(uint8_t scale);
+
+// Force the next ws2812_update() to re-encode and resend every LED
+void ws2812_invalidate(void);
+
 // Send buffer to LEDs (call this to update display)
+// Only LEDs changed since the last call are re-encoded, and nothing is sent
+// when nothing changed.
+// With CONFIG_WS2812_ASYNC this returns once the frame is encoded and the
+// transfer has started; the previous frame may still be on the wire.
 void ws2812_update(void);
 
+// Wait until no transfer is in flight (no-op in blocking mode)
+void ws2812_sync(void);
+
 // Set global brightness (0-255, where 255 = full brightness)
 void ws2812_set_brightness(uint8_t brightness);
 
+#ifdef CONFIG_WS2812_BACKEND_SPI
+// SPI encoding chosen by ws2812_init() (symbol widths and timing margins)
+const struct ws2812_encoding *ws2812_get_encoding(void);
+
+// A slice of the LED chain driven by its own SPI controller
+struct ws2812_segment_info {
+    const char *name;             // Strip node
+    const struct device *bus;     // SPI controller
+    uint16_t first;               // First LED of the chain in this segment
+    uint16_t count;
+    size_t len;                   // SPI bytes per frame, lead and trail included
+};
+
+// Number of output segments (1 unless the devicetree lists several)
+int ws2812_num_segments(void);
+
+// Describe segment s; -EINVAL if there is no such segment
+int ws2812_get_segment(int s, struct ws2812_segment_info *info);
+#endif
+
+// Enable/disable gamma 2.2 correction (default: CONFIG_WS2812_GAMMA)
+void ws2812_set_gamma(bool enable);
+
+// Whether gamma correction is on
+bool ws2812_get_gamma(void);
+
+#ifdef CONFIG_WS2812_STREAM
+struct ws2812_stream_info {
+    uint16_t chunk_leds;      // LEDs per chunk
+    uint16_t chunks;          // Chunks per frame
+    size_t chunk_bytes;       // Size of each of the two chunk buffers
+    uint32_t chunk_wire_ns;   // Time one full chunk takes on the wire
+    uint32_t max_gap_ns;      // Longest idle time between two chunks so far
+    uint32_t underruns;       // Gaps that reached CONFIG_WS2812_RESET_US
+};
+
+// Streaming layout and how well the encoder has kept up with the wire
+void ws2812_stream_get_info(struct ws2812_stream_info *info);
+#endif
+
+#ifdef CONFIG_WS2812_TRUNCATE
+struct ws2812_truncate_info {
+    uint32_t frames;          // Frames sent
+    uint32_t full_frames;     // Of those, sent whole (refresh, brightness or gamma
+                              // change, or the last LED of every segment changed)
+    uint64_t leds_sent;       // LEDs sent over all frames
+    uint32_t refresh_ms;      // Full refresh period, 0 if never forced
+};
+
+// How much of the chain truncated frames have actually sent
+void ws2812_truncate_get_info(struct ws2812_truncate_info *info);
+#endif
+
+// Static RAM held by the driver, in bytes
+struct ws2812_ram_info {
+    size_t framebuffer;       // The chain in wire order
+    size_t tables;            // Color and encode tables, dirty bitmaps
+    size_t spi_bufs;          // SPI (or stream chunk) buffers, as allocated for
+                              // CONFIG_WS2812_MAX_SYMBOL_BITS
+    size_t spi_bufs_used;     // Of those, what the chosen encoding fills
+    uint8_t symbol_bits;      // SPI bits per LED bit chosen at init, 0 without SPI
+};
+
+void ws2812_get_ram_info(struct ws2812_ram_info *info);
+
+#ifdef CONFIG_WS2812_BENCH
+struct ws2812_bench_result {
+    uint32_t reference_cycles;  // Original per-bit encode loop
+    uint32_t lut_cycles;        // Table-driven encode, all LEDs
+    uint32_t incremental_cycles;  // Table-driven encode, 32 dirty LEDs
+    uint32_t lut_build_cycles;  // One table rebuild
+};
+
+// Time one frame encode with both encoders (call with matrix_mutex held)
+void ws2812_bench_encode(struct ws2812_bench_result *res);
+#endif
+
+#ifdef CONFIG_WS2812_BENCH_SUITE
+// Run the boot-time benchmark suite; returns the number of cases over budget
+int ws2812_bench_suite_run(void);
+
+#ifdef CONFIG_WS2812_STREAM
+// Encode chunk k of the current frame without sending it
+void ws2812_bench_stream_chunk(int k);
+#endif
+#endif
+
 // Mutex for thread-safe access
 extern struct k_mutex matrix_mutex;
 
@@ -0,0 +1,168 @@
+/*
+ * Animation executor
+ *
+ * Effects are k_work_delayable items instead of threads. Each priority
+ * class has one work queue thread, so any number of effects costs four
+ * stacks plus one small struct each, where the thread-per-effect model
+ * needs a stack and a struct k_thread per effect. Steps are scheduled on
+ * absolute deadlines; how late each one starts is recorded per effect
+ * ("ws2812 anim").
+ */
+
+#include "ws2812_anim.h"
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+
+LOG_MODULE_REGISTER(ws2812_anim, LOG_LEVEL_INF);
+
+#ifdef CONFIG_WS2812_ANIM
+
+static const struct {
+    const char *name;
+    int prio;
+} classes[WS2812_ANIM_NUM_CLASSES] = {
+    [WS2812_ANIM_HIGH] = { "anim_high", CONFIG_WS2812_ANIM_HIGH_PRIO },
+    [WS2812_ANIM_ABOVE_NORMAL] = { "anim_above", CONFIG_WS2812_ANIM_ABOVE_NORMAL_PRIO },
+    [WS2812_ANIM_NORMAL] = { "anim_normal", CONFIG_WS2812_ANIM_NORMAL_PRIO },
+    [WS2812_ANIM_LOW] = { "anim_low", CONFIG_WS2812_ANIM_LOW_PRIO },
+};
+
+K_THREAD_STACK_ARRAY_DEFINE(anim_stacks, WS2812_ANIM_NUM_CLASSES, CONFIG_WS2812_ANIM_STACK_SIZE);
+static struct k_work_q queues[WS2812_ANIM_NUM_CLASSES];
+static bool queues_started;
+
+static struct ws2812_anim *effects[CONFIG_WS2812_ANIM_MAX_EFFECTS];
+static int num_effects;
+static K_MUTEX_DEFINE(register_lock);
+
+static void start_queues(void) {
+    for (int c = 0; c < WS2812_ANIM_NUM_CLASSES; c++) {
+        const struct k_work_queue_config cfg = { .name = classes[c].name };
+
+        k_work_queue_start(&queues[c], anim_stacks[c], K_THREAD_STACK_SIZEOF(anim_stacks[c]),
+                           classes[c].prio, &cfg);
+    }
+    queues_started = true;
+    LOG_INF("Animation executor: %d threads, %d byte stacks", WS2812_ANIM_NUM_CLASSES,
+            CONFIG_WS2812_ANIM_STACK_SIZE);
+}
+
+static void anim_work(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct ws2812_anim *anim = CONTAINER_OF(dwork, struct ws2812_anim, work);
+    k_ticks_t period = k_ms_to_ticks_ceil64(anim->period_ms);
+    k_ticks_t now = k_uptime_ticks();
+
+    ws2812_anim_jitter_add(&anim->jitter, now - anim->deadline);
+    anim->step(anim);
+
+    if (!anim->running) {
+        return;
+    }
+
+    // Skip the periods a long step or a busy class overran, rather than
+    // running them back to back
+    anim->deadline += period;
+    now = k_uptime_ticks();
+    if (anim->deadline < now) {
+        k_ticks_t behind = (now - anim->deadline) / period + 1;
+
+        anim->jitter.missed += behind;
+        anim->deadline += behind * period;
+    }
+    k_work_schedule_for_queue(&queues[anim->cls], dwork, K_TIMEOUT_ABS_TICKS(anim->deadline));
+}
+
+int ws2812_anim_start(struct ws2812_anim *anim) {
+    int i;
+
+    if (anim->cls >= WS2812_ANIM_NUM_CLASSES || anim->period_ms == 0) {
+        LOG_ERR("Effect %s: bad class %u or period %u ms", anim->name, anim->cls,
+                anim->period_ms);
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&register_lock, K_FOREVER);
+
+    if (!queues_started) {
+        start_queues();
+    }
+
+    for (i = 0; i < num_effects && effects[i] != anim; i++) {
+    }
+    if (i == num_effects) {
+        if (num_effects == ARRAY_SIZE(effects)) {
+            k_mutex_unlock(&register_lock);
+            LOG_ERR("No room for effect %s (CONFIG_WS2812_ANIM_MAX_EFFECTS=%d)", anim->name,
+                    CONFIG_WS2812_ANIM_MAX_EFFECTS);
+            return -ENOMEM;
+        }
+        k_work_init_delayable(&anim->work, anim_work);
+        effects[num_effects++] = anim;
+    }
+
+    anim->running = true;
+    anim->deadline = k_uptime_ticks();
+    k_work_schedule_for_queue(&queues[anim->cls], &anim->work, K_NO_WAIT);
+
+    k_mutex_unlock(&register_lock);
+    return 0;
+}
+
+void ws2812_anim_stop(struct ws2812_anim *anim) {
+    struct k_work_sync sync;
+
+    anim->running = false;
+    k_work_cancel_delayable_sync(&anim->work, &sync);
+}
+
+void ws2812_anim_set_class(struct ws2812_anim *anim, enum ws2812_anim_class cls) {
+    if (cls < WS2812_ANIM_NUM_CLASSES) {
+        anim->cls = cls;
+    }
+}
+
+#ifdef CONFIG_WS2812_SHELL
+static int cmd_anim(const struct shell *sh, size_t argc, char **argv) {
+    size_t executor_ram = sizeof(queues) + sizeof(anim_stacks) +
+                          num_effects * sizeof(struct ws2812_anim);
+
+    for (int c = 0; c < WS2812_ANIM_NUM_CLASSES; c++) {
+#ifdef CONFIG_THREAD_STACK_INFO
+        size_t unused = 0;
+
+        if (queues_started) {
+            k_thread_stack_space_get(&queues[c].thread, &unused);
+        }
+        shell_print(sh, "%-12s prio %3d, stack %u of %u bytes used", classes[c].name,
+                    classes[c].prio, (unsigned int)(CONFIG_WS2812_ANIM_STACK_SIZE - unused),
+                    CONFIG_WS2812_ANIM_STACK_SIZE);
+#else
+        shell_print(sh, "%-12s prio %3d", classes[c].name, classes[c].prio);
+#endif
+    }
+
+    shell_print(sh, "%-14s %-12s %6s %8s %6s %10s %10s", "effect", "class", "period", "runs",
+                "missed", "late avg", "late max");
+    for (int i = 0; i < num_effects; i++) {
+        const struct ws2812_anim *a = effects[i];
+        uint32_t avg = a->jitter.runs ? a->jitter.late_total_us / a->jitter.runs : 0;
+
+        shell_print(sh, "%-14s %-12s %4u ms %8u %6u %7u us %7u us", a->name,
+                    classes[a->cls].name, a->period_ms, a->jitter.runs, a->jitter.missed, avg,
+                    a->jitter.late_max_us);
+    }
+
+    // What the same effects would cost as one thread each with the same stack
+    shell_print(sh, "RAM: executor %u bytes, thread per effect %u bytes",
+                (unsigned int)executor_ram,
+                (unsigned int)(num_effects * (sizeof(struct k_thread) +
+                                              K_THREAD_STACK_LEN(CONFIG_WS2812_ANIM_STACK_SIZE))));
+    return 0;
+}
+
+SHELL_SUBCMD_ADD((ws2812), anim, NULL, "Animation executor threads, effects and lateness",
+                 cmd_anim, 1, 0);
+#endif
+
+#endif /* CONFIG_WS2812_ANIM */
@@ -0,0 +1,69 @@
+#ifndef WS2812_ANIM_H
+#define WS2812_ANIM_H
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+
+// Priority class of an effect. Each class is one work queue thread, at
+// CONFIG_WS2812_ANIM_{HIGH,ABOVE_NORMAL,NORMAL,LOW}_PRIO; effects of the
+// same class run one after the other on it.
+enum ws2812_anim_class {
+    WS2812_ANIM_HIGH,
+    WS2812_ANIM_ABOVE_NORMAL,
+    WS2812_ANIM_NORMAL,
+    WS2812_ANIM_LOW,
+    WS2812_ANIM_NUM_CLASSES,
+};
+
+// How late a periodic job ran relative to when it was due
+struct ws2812_anim_jitter {
+    uint32_t runs;
+    uint32_t missed;        // Whole periods skipped because it ran too late
+    uint64_t late_total_us;
+    uint32_t late_max_us;
+};
+
+// Count one run that started late ticks after it was due
+static inline void ws2812_anim_jitter_add(struct ws2812_anim_jitter *j, k_ticks_t late) {
+    uint32_t late_us = late > 0 ? k_ticks_to_us_floor32(late) : 0;
+
+    j->runs++;
+    j->late_total_us += late_us;
+    j->late_max_us = MAX(j->late_max_us, late_us);
+}
+
+// An effect: step() runs every period_ms on its class's executor thread.
+// A step must not sleep for long, it holds up every other effect of its
+// class.
+struct ws2812_anim {
+    const char *name;
+    void (*step)(struct ws2812_anim *anim);
+    uint32_t period_ms;
+    uint8_t cls;            // enum ws2812_anim_class
+    void *user_data;
+
+    // Executor state
+    struct k_work_delayable work;
+    k_ticks_t deadline;     // When the current or next step is due
+    bool running;
+    struct ws2812_anim_jitter jitter;
+};
+
+#define WS2812_ANIM_DEFINE(_name, _step, _period_ms, _cls, _user_data)  \
+    struct ws2812_anim _name = {                                        \
+        .name = #_name, .step = (_step), .period_ms = (_period_ms),      \
+        .cls = (_cls), .user_data = (_user_data),                       \
+    }
+
+// Run the effect's first step now and then every period_ms, on absolute
+// deadlines so the period does not drift. The executor threads start with
+// the first effect. At most CONFIG_WS2812_ANIM_MAX_EFFECTS effects.
+int ws2812_anim_start(struct ws2812_anim *anim);
+
+// Stop the effect, waiting for a running step to finish
+void ws2812_anim_stop(struct ws2812_anim *anim);
+
+// Move the effect to another class from its next step on
+void ws2812_anim_set_class(struct ws2812_anim *anim, enum ws2812_anim_class cls);
+
+#endif /* WS2812_ANIM_H */
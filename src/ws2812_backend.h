@@ -0,0 +1,51 @@
+#ifndef WS2812_BACKEND_H
+#define WS2812_BACKEND_H
+
+#include "ws2812.h"
+
+// Output backends: how ws2812_update() gets a frame to the LEDs. The front
+// end (ws2812.c) keeps the framebuffer in chain order, the dirty tracking
+// and the brightness/gamma table, paces frames (one in flight, the reset
+// gap between them) and times them. Exactly one backend is built, chosen
+// with CONFIG_WS2812_BACKEND_*, and it defines ws2812_backend:
+//
+//   spi        the built-in SPI encoder (ws2812.c): blocking, or DMA with
+//              CONFIG_WS2812_ASYNC, plus streaming, segments and truncation
+//   led_strip  Zephyr's led_strip driver on the led-strip alias
+//   null       no output; keeps the last frame for tests (ws2812_capture_*)
+struct ws2812_backend {
+    const char *name;
+
+    // Set up the output for WS2812_CHAIN_LEN LEDs, from ws2812_init()
+    int (*init)(void);
+
+    // Prepare the next frame (matrix_mutex held) while the previous one may
+    // still be going out. leds is the chain in wire order and lut maps each
+    // channel value to its level after brightness and gamma.
+    void (*encode)(const rgb_t *leds, const uint8_t *lut);
+
+    // Put the prepared frame on the wire, the previous one being done and
+    // the reset gap over. ws2812_backend_done() must follow, from any
+    // context, once the frame is out.
+    void (*start)(void);
+
+    // Nominal wire time of a whole frame in ns, for the benchmark
+    uint32_t (*frame_ns)(void);
+
+    // start() returns before the frame is out: ws2812_update() then
+    // returns too, instead of waiting for ws2812_backend_done()
+    bool async;
+};
+
+extern const struct ws2812_backend ws2812_backend;
+
+// The frame handed to start() is out (result < 0 if it failed)
+void ws2812_backend_done(int result);
+
+#ifdef CONFIG_WS2812_BACKEND_NULL
+// Frames the null backend has taken so far; *leds gets the last one, in
+// chain order with brightness and gamma applied
+uint32_t ws2812_capture_get(const rgb_t **leds);
+#endif
+
+#endif /* WS2812_BACKEND_H */
@@ -0,0 +1,69 @@
+/*
+ * led_strip output backend
+ *
+ * Hands each frame to Zephyr's led_strip driver on the led-strip alias
+ * (worldsemi,ws2812-spi on the SAM E54), which does its own encoding and
+ * reset delay. The front end only converts the chain through the color
+ * table into the driver's struct led_rgb order. led_strip_update_rgb()
+ * blocks until the frame is out, so this backend is never async.
+ */
+
+#include "ws2812_backend.h"
+#include <zephyr/device.h>
+#include <zephyr/drivers/led_strip.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(ws2812_led_strip, LOG_LEVEL_INF);
+
+#ifdef CONFIG_WS2812_BACKEND_LED_STRIP
+
+#define STRIP_NODE DT_ALIAS(led_strip)
+
+BUILD_ASSERT(DT_PROP(STRIP_NODE, chain_length) >= WS2812_CHAIN_LEN,
+             "The led-strip node is shorter than the LED chain");
+
+// SPI clock of the worldsemi,ws2812-spi driver, which sends 8 SPI bits per
+// LED bit; other led_strip drivers are assumed to run at the nominal
+// 1.25 us per bit
+#define STRIP_SPI_HZ DT_PROP_OR(STRIP_NODE, spi_max_frequency, 0)
+#define STRIP_BIT_NS (STRIP_SPI_HZ ? 8ULL * NSEC_PER_SEC / STRIP_SPI_HZ : 1250)
+
+static const struct device *const strip = DEVICE_DT_GET(STRIP_NODE);
+static struct led_rgb pixels[WS2812_CHAIN_LEN];
+
+static int led_strip_backend_init(void) {
+    if (!device_is_ready(strip)) {
+        LOG_ERR("LED strip %s not ready", strip->name);
+        return -ENODEV;
+    }
+    LOG_INF("Output through the %s led_strip driver", strip->name);
+    return 0;
+}
+
+static void led_strip_backend_encode(const rgb_t *leds, const uint8_t *lut) {
+    for (int i = 0; i < WS2812_CHAIN_LEN; i++) {
+        pixels[i] = (struct led_rgb){
+            .r = lut[leds[i].r],
+            .g = lut[leds[i].g],
+            .b = lut[leds[i].b],
+        };
+    }
+}
+
+static void led_strip_backend_start(void) {
+    ws2812_backend_done(led_strip_update_rgb(strip, pixels, WS2812_CHAIN_LEN));
+}
+
+static uint32_t led_strip_backend_frame_ns(void) {
+    return WS2812_CHAIN_LEN * 24 * STRIP_BIT_NS;
+}
+
+const struct ws2812_backend ws2812_backend = {
+    .name = "led_strip",
+    .init = led_strip_backend_init,
+    .encode = led_strip_backend_encode,
+    .start = led_strip_backend_start,
+    .frame_ns = led_strip_backend_frame_ns,
+};
+
+#endif /* CONFIG_WS2812_BACKEND_LED_STRIP */
@@ -0,0 +1,52 @@
+/*
+ * Null output backend
+ *
+ * Sends nothing: each frame is copied, color table applied, into a capture
+ * buffer that tests and the benchmark read back with ws2812_capture_get().
+ * A frame is done as soon as it starts, so ws2812_update() costs only the
+ * front end and the copy.
+ */
+
+#include "ws2812_backend.h"
+
+#ifdef CONFIG_WS2812_BACKEND_NULL
+
+// Nominal WS2812 bit time, for the reported wire time
+#define NULL_BIT_NS 1250
+
+static rgb_t capture[WS2812_CHAIN_LEN];
+static uint32_t capture_frames;
+
+static int null_backend_init(void) {
+    return 0;
+}
+
+static void null_backend_encode(const rgb_t *leds, const uint8_t *lut) {
+    for (int i = 0; i < WS2812_CHAIN_LEN; i++) {
+        capture[i] = (rgb_t){ .g = lut[leds[i].g], .r = lut[leds[i].r], .b = lut[leds[i].b] };
+    }
+}
+
+static void null_backend_start(void) {
+    capture_frames++;
+    ws2812_backend_done(0);
+}
+
+static uint32_t null_backend_frame_ns(void) {
+    return WS2812_CHAIN_LEN * 24 * NULL_BIT_NS;
+}
+
+const struct ws2812_backend ws2812_backend = {
+    .name = "null",
+    .init = null_backend_init,
+    .encode = null_backend_encode,
+    .start = null_backend_start,
+    .frame_ns = null_backend_frame_ns,
+};
+
+uint32_t ws2812_capture_get(const rgb_t **leds) {
+    *leds = capture;
+    return capture_frames;
+}
+
+#endif /* CONFIG_WS2812_BACKEND_NULL */
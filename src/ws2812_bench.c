@@ -0,0 +1,136 @@
+/*
+ * "ws2812 bench" - cycle counts for the driver hot paths
+ *
+ *   ws2812 bench encode   per-bit vs table encoder, full and incremental
+ *   ws2812 bench draw     per-pixel loops vs the bulk drawing API
+ *
+ * Both run on the live framebuffer with matrix_mutex held; "draw" leaves
+ * the matrix cleared.
+ */
+
+#include "ws2812.h"
+#include <zephyr/shell/shell.h>
+
+#ifdef CONFIG_WS2812_BENCH
+
+#define BENCH_ROUNDS 16
+
+static int cmd_bench_encode(const struct shell *sh, size_t argc, char **argv) {
+    struct ws2812_bench_result res;
+
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+    ws2812_bench_encode(&res);
+    k_mutex_unlock(&matrix_mutex);
+
+    shell_print(sh, "Encode %d LEDs:", WS2812_CHAIN_LEN);
+    shell_print(sh, "  per-bit loop:  %u cycles (%u us)", res.reference_cycles,
+                k_cyc_to_us_floor32(res.reference_cycles));
+    shell_print(sh, "  lookup table:  %u cycles (%u us)", res.lut_cycles,
+                k_cyc_to_us_floor32(res.lut_cycles));
+    shell_print(sh, "  32 dirty LEDs: %u cycles (%u us)", res.incremental_cycles,
+                k_cyc_to_us_floor32(res.incremental_cycles));
+    shell_print(sh, "  table rebuild: %u cycles (%u us)", res.lut_build_cycles,
+                k_cyc_to_us_floor32(res.lut_build_cycles));
+    return 0;
+}
+
+// Alternate between two colors so every round really changes pixels
+static rgb_t bench_color(int round) {
+    return (round & 1) ? (rgb_t){10, 20, 30} : (rgb_t){30, 20, 10};
+}
+
+static void per_pixel_rect(int x, int y, int w, int h, rgb_t color) {
+    for (int py = y; py < y + h; py++) {
+        for (int px = x; px < x + w; px++) {
+            ws2812_set_pixel(px, py, color);
+        }
+    }
+}
+
+static void per_pixel_blit(int x, int y, int w, int h, const rgb_t *sprite) {
+    for (int py = 0; py < h; py++) {
+        for (int px = 0; px < w; px++) {
+            ws2812_set_pixel(x + px, y + py, sprite[py * w + px]);
+        }
+    }
+}
+
+static void print_pair(const struct shell *sh, const char *name, uint32_t pixel, uint32_t bulk) {
+    shell_print(sh, "  %-14s per-pixel %6u  bulk %6u cycles", name,
+                pixel / BENCH_ROUNDS, bulk / BENCH_ROUNDS);
+}
+
+static int cmd_bench_draw(const struct shell *sh, size_t argc, char **argv) {
+    static rgb_t sprite[8 * 8];
+    uint32_t start, pixel, bulk;
+
+    for (int i = 0; i < ARRAY_SIZE(sprite); i++) {
+        sprite[i] = (rgb_t){i, 2 * i, 3 * i};
+    }
+
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+
+    shell_print(sh, "Average per call over %d rounds:", BENCH_ROUNDS);
+
+    start = k_cycle_get_32();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        per_pixel_rect(0, 0, MATRIX_WIDTH, MATRIX_HEIGHT, bench_color(r));
+    }
+    pixel = k_cycle_get_32() - start;
+    start = k_cycle_get_32();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        ws2812_fill(bench_color(r));
+    }
+    bulk = k_cycle_get_32() - start;
+    print_pair(sh, "fill", pixel, bulk);
+
+    start = k_cycle_get_32();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        per_pixel_rect(2, 2, 8, 8, bench_color(r));
+    }
+    pixel = k_cycle_get_32() - start;
+    start = k_cycle_get_32();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        ws2812_fill_rect(2, 2, 8, 8, bench_color(r));
+    }
+    bulk = k_cycle_get_32() - start;
+    print_pair(sh, "fill_rect 8x8", pixel, bulk);
+
+    start = k_cycle_get_32();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        per_pixel_blit(r & 1, 3, 8, 8, sprite);
+    }
+    pixel = k_cycle_get_32() - start;
+    start = k_cycle_get_32();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        ws2812_blit(r & 1, 3, 8, 8, sprite);
+    }
+    bulk = k_cycle_get_32() - start;
+    print_pair(sh, "blit 8x8", pixel, bulk);
+
+    start = k_cycle_get_32();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        per_pixel_blit(r & 1, 1, MIN(8, MATRIX_WIDTH), 1, sprite);
+    }
+    pixel = k_cycle_get_32() - start;
+    start = k_cycle_get_32();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        ws2812_write_row(r & 1, 1, sprite, MIN(8, MATRIX_WIDTH));
+    }
+    bulk = k_cycle_get_32() - start;
+    print_pair(sh, "write_row 8", pixel, bulk);
+
+    ws2812_clear();
+    k_mutex_unlock(&matrix_mutex);
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_bench,
+    SHELL_CMD(encode, NULL, "Compare encoder cycle counts", cmd_bench_encode),
+    SHELL_CMD(draw, NULL, "Compare per-pixel and bulk drawing", cmd_bench_draw),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_SUBCMD_ADD((ws2812), bench, &sub_bench, "Driver benchmarks", NULL, 1, 0);
+
+#endif /* CONFIG_WS2812_BENCH */
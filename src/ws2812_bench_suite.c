@@ -0,0 +1,643 @@
+/*
+ * Boot-time benchmark suite for the render and encode hot paths
+ *
+ * Times each case over CONFIG_WS2812_BENCH_ITERATIONS calls and prints the
+ * cost per call. Budgets come from CONFIG_WS2812_BENCH_BUDGETS, e.g.
+ *
+ *   "set_pixel=200,update_full=80000,quadrant=500"
+ *
+ * Each entry is a maximum in ns per call, except "quadrant", which is a
+ * minimum in frames per second. The suite ends with "BENCH PASS" or
+ * "BENCH FAIL"; the native_sim scenario in sample.yaml matches on it.
+ *
+ * With the emulated chain (CONFIG_WS2812_EMUL) the suite also decodes one
+ * frame off the wire and fails if any LED differs from the framebuffer or
+ * any symbol is malformed.
+ *
+ * With CONFIG_WS2812_STREAM it also fails if encoding one chunk takes longer
+ * than sending one at the configured SPI clock.
+ *
+ * Every build reports what a full frame costs through the configured
+ * output backend: time in ws2812_update(), time until the frame is out,
+ * and its nominal wire time. Build once per CONFIG_WS2812_BACKEND_* to
+ * compare them on a board. The null backend's capture is also checked
+ * against the framebuffer.
+ *
+ * On hardware the cycle counter is used. On native_sim simulated time
+ * stands still while code runs, so the host monotonic clock is used instead
+ * (src/native/ws2812_host_clock.c).
+ */
+
+#include "ws2812.h"
+#include "ws2812_backend.h"
+#include "patterns.h"
+#include "quadrant_simple_test.h"
+#include "ws2812_fixed.h"
+#include "ws2812_kernels.h"
+#include "ws2812_entity.h"
+#include "ws2812_emul.h"
+#include "ws2812_clip.h"
+#include "ws2812_cpu.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef CONFIG_WS2812_BENCH_SUITE
+
+#define BENCH_ITERS CONFIG_WS2812_BENCH_ITERATIONS
+
+#ifdef CONFIG_NATIVE_LIBRARY
+uint64_t ws2812_host_clock_ns(void);
+
+typedef uint64_t bench_stamp_t;
+
+static inline bench_stamp_t bench_now(void) {
+    return ws2812_host_clock_ns();
+}
+
+static inline uint64_t bench_elapsed_ns(bench_stamp_t start) {
+    return ws2812_host_clock_ns() - start;
+}
+#else
+typedef uint32_t bench_stamp_t;
+
+static inline bench_stamp_t bench_now(void) {
+    return k_cycle_get_32();
+}
+
+static inline uint64_t bench_elapsed_ns(bench_stamp_t start) {
+    return k_cyc_to_ns_floor64(k_cycle_get_32() - start);
+}
+#endif
+
+struct bench_case {
+    const char *name;
+    // Untimed preparation for round i (may be NULL)
+    void (*setup)(int i);
+    // The timed call; returns how many operations it performed
+    int (*run)(int i);
+};
+
+static rgb_t bench_color(int i) {
+    return (i & 1) ? (rgb_t){10, 20, 30} : (rgb_t){30, 20, 10};
+}
+
+static int run_set_pixel(int i) {
+    rgb_t color = bench_color(i);
+
+    for (int y = 0; y < MATRIX_HEIGHT; y++) {
+        for (int x = 0; x < MATRIX_WIDTH; x++) {
+            ws2812_set_pixel(x, y, color);
+        }
+    }
+    return NUM_LEDS;
+}
+
+static volatile uint8_t bench_sink;
+
+static int run_get_pixel(int i) {
+    uint8_t acc = 0;
+
+    for (int y = 0; y < MATRIX_HEIGHT; y++) {
+        for (int x = 0; x < MATRIX_WIDTH; x++) {
+            acc += ws2812_get_pixel(x, y).g;
+        }
+    }
+    bench_sink = acc;
+    return NUM_LEDS;
+}
+
+static void setup_fill(int i) {
+    ws2812_fill(bench_color(i));
+}
+
+static int run_clear(int i) {
+    ws2812_clear();
+    return 1;
+}
+
+static void setup_invalidate(int i) {
+    ws2812_invalidate();
+}
+
+// With the emulated SPI bus the transfer is free, so this is the encode
+static int run_update(int i) {
+    ws2812_update();
+    return 1;
+}
+
+static void setup_32px(int i) {
+    for (int n = 0; n < 32; n++) {
+        ws2812_set_pixel(n % MATRIX_WIDTH, (n / MATRIX_WIDTH) % MATRIX_HEIGHT, bench_color(i));
+    }
+}
+
+static int run_hsv_to_rgb(int i) {
+    uint8_t acc = 0;
+
+    for (int h = 0; h < 256; h++) {
+        acc += hsv_to_rgb(h, 255, i).r;
+    }
+    bench_sink = acc;
+    return 256;
+}
+
+static int run_sin16(int i) {
+    int16_t acc = 0;
+
+    for (int a = 0; a < 256; a++) {
+        acc += sin16(a * 256 + i);
+    }
+    bench_sink = (uint8_t)acc;
+    return 256;
+}
+
+static int run_fade(int i) {
+    ws2812_fade(Q8(0.95));
+    return 1;
+}
+
+// Whole-frame kernels on private frames, so the framebuffer is untouched
+static rgb_t kernel_frame[3][NUM_LEDS];
+
+static void setup_kernel(int i) {
+    ws2812_kernel_fill(kernel_frame[0], NUM_LEDS, bench_color(i));
+    ws2812_kernel_fill(kernel_frame[1], NUM_LEDS, bench_color(i + 1));
+}
+
+static int run_kernel_add(int i) {
+    ws2812_kernel_add(kernel_frame[0], kernel_frame[1], NUM_LEDS);
+    return 1;
+}
+
+static int run_kernel_blend(int i) {
+    ws2812_kernel_blend(kernel_frame[0], kernel_frame[1], NUM_LEDS, 96);
+    return 1;
+}
+
+// alpha 128 takes the halving-add path on SIMD32 cores
+static int run_kernel_blend_half(int i) {
+    ws2812_kernel_blend(kernel_frame[0], kernel_frame[1], NUM_LEDS, 128);
+    return 1;
+}
+
+// 256 particles bouncing around the whole matrix, stepped and redrawn in
+// one pass
+#define BENCH_ENTITIES 256
+
+WS2812_ENTITY_POOL_DEFINE(bench_pool, BENCH_ENTITIES);
+
+static const struct ws2812_entity_view bench_view = {
+    .x = 0, .y = 0, .w = MATRIX_WIDTH, .h = MATRIX_HEIGHT,
+};
+
+static int run_entities(int i) {
+    if (bench_pool.count == 0) {
+        for (int n = 0; n < BENCH_ENTITIES; n++) {
+            struct ws2812_entity_desc desc = {
+                .x = Q16(0.6) + q16_from_int(n % (MATRIX_WIDTH - 1)),
+                .y = Q16(0.6) + q16_from_int(n / MATRIX_WIDTH % (MATRIX_HEIGHT - 1)),
+                .vx = (n % 7 - 3) * Q16(0.1),
+                .vy = (n % 5 - 2) * Q16(0.1),
+                .w = 1,
+                .h = 1,
+                .color = bench_color(n),
+            };
+
+            ws2812_entity_add(&bench_pool, &bench_view, &desc);
+        }
+    }
+    ws2812_entity_update(&bench_pool, 0, BENCH_ENTITIES);
+    return 1;
+}
+
+#ifdef CONFIG_WS2812_PATTERNS
+// Registered patterns are timed one after the other through these
+static const struct ws2812_pattern *bench_pattern;
+static uint8_t bench_pattern_state[CONFIG_WS2812_PATTERN_STATE_SIZE] __aligned(8);
+
+static void setup_pattern(int i) {
+    if (i == 0) {
+        memset(bench_pattern_state, 0, sizeof(bench_pattern_state));
+        if (bench_pattern->init != NULL) {
+            bench_pattern->init(bench_pattern_state);
+        }
+    }
+}
+
+static int run_pattern(int i) {
+    bench_pattern->step(bench_pattern_state);
+    return 1;
+}
+#endif
+
+#ifdef CONFIG_WS2812_CLIP
+// Built-in clips are decoded one after the other through these, one frame
+// per call and without sending, so the time is the decode cost alone
+static const struct ws2812_clip *bench_clip;
+static struct ws2812_clip_player bench_player;
+
+static void setup_clip(int i) {
+    if (i == 0) {
+        ws2812_clip_open(&bench_player, bench_clip->data, bench_clip->size);
+    }
+}
+
+static int run_clip(int i) {
+    ws2812_clip_next(&bench_player);
+    return 1;
+}
+#endif
+
+#ifdef CONFIG_WS2812_CPU
+// One CPU share sample over every thread, as the priority visualizer takes
+// each frame
+static int run_cpu_sample(int i) {
+    ws2812_cpu_sample();
+    return 1;
+}
+#endif
+
+// One frame of the quadrant demo: all four quadrants drawn, then sent
+static int run_quadrant(int i) {
+    simple_test_render_frame();
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+    ws2812_update();
+    k_mutex_unlock(&matrix_mutex);
+    return 1;
+}
+
+static const struct bench_case cases[] = {
+    { "set_pixel", NULL, run_set_pixel },
+    { "get_pixel", NULL, run_get_pixel },
+    { "clear", setup_fill, run_clear },
+    { "update_full", setup_invalidate, run_update },
+    { "update_32px", setup_32px, run_update },
+    { "hsv_to_rgb", NULL, run_hsv_to_rgb },
+    { "sin16", NULL, run_sin16 },
+    { "fade", setup_fill, run_fade },
+    { "kernel_add", setup_kernel, run_kernel_add },
+    { "kernel_blend", setup_kernel, run_kernel_blend },
+    { "kernel_blend_half", setup_kernel, run_kernel_blend_half },
+    { "entities", NULL, run_entities },
+#ifdef CONFIG_WS2812_CPU
+    { "cpu_sample", NULL, run_cpu_sample },
+#endif
+};
+
+// Look up "name=value" in CONFIG_WS2812_BENCH_BUDGETS; 0 if absent
+static uint32_t bench_budget(const char *name) {
+    const char *p = CONFIG_WS2812_BENCH_BUDGETS;
+    size_t len = strlen(name);
+
+    while (*p != '\0') {
+        if (strncmp(p, name, len) == 0 && p[len] == '=') {
+            return strtoul(p + len + 1, NULL, 10);
+        }
+        p = strchr(p, ',');
+        if (p == NULL) {
+            break;
+        }
+        p++;
+        while (*p == ' ') {
+            p++;
+        }
+    }
+    return 0;
+}
+
+// Average ns per operation over BENCH_ITERS rounds
+static uint32_t bench_run(const struct bench_case *c) {
+    uint64_t total_ns = 0;
+    uint32_t ops = 0;
+
+    for (int i = 0; i < BENCH_ITERS; i++) {
+        if (c->setup != NULL) {
+            c->setup(i);
+        }
+        bench_stamp_t start = bench_now();
+        ops += c->run(i);
+        total_ns += bench_elapsed_ns(start);
+    }
+    return ops ? total_ns / ops : 0;
+}
+
+// Time one case and report it against its budget; returns 1 if over
+static int bench_check(const struct bench_case *c) {
+    uint32_t ns = bench_run(c);
+    uint32_t budget = bench_budget(c->name);
+    bool over = budget != 0 && ns > budget;
+
+#ifdef CONFIG_NATIVE_LIBRARY
+    printk("  %-28s %8u ns/call  budget %8u  %s\n", c->name, ns, budget, over ? "OVER" : "ok");
+#else
+    printk("  %-28s %8u ns/call %8u cycles/call  budget %8u  %s\n", c->name, ns,
+           (uint32_t)k_ns_to_cyc_floor64(ns), budget, over ? "OVER" : "ok");
+#endif
+    return over;
+}
+
+// Blend two frames at every alpha and compare with the per-byte lerp the
+// SWAR kernel implements, so the SIMD32 paths (the 50% halving add
+// included) are held to the same results. One LED short of the frame, so
+// the byte-at-a-time tail runs too. Returns 1 if any byte differs.
+static int bench_check_kernels(void) {
+    const size_t n = NUM_LEDS - 1;
+    const uint8_t *d = (const uint8_t *)kernel_frame[0];
+    const uint8_t *s = (const uint8_t *)kernel_frame[1];
+    uint8_t *out = (uint8_t *)kernel_frame[2];
+    int wrong = 0;
+
+    for (size_t i = 0; i < NUM_LEDS; i++) {
+        kernel_frame[0][i] = hsv_to_rgb(i * 7, 255 - i % 64, i * 3);
+        kernel_frame[1][i] = hsv_to_rgb(i * 11 + 128, 255, 255 - i * 5 % 256);
+    }
+
+    for (int alpha = 0; alpha < 256; alpha++) {
+        uint32_t a = alpha + (alpha > 128);
+
+        memcpy(out, d, n * sizeof(rgb_t));
+        ws2812_kernel_blend(kernel_frame[2], kernel_frame[1], n, alpha);
+        for (size_t i = 0; i < n * sizeof(rgb_t); i++) {
+            wrong += out[i] != ((s[i] * a + d[i] * (256 - a)) >> 8);
+        }
+    }
+
+    printk("  kernels: blend at 256 alphas, %d bytes wrong\n", wrong);
+    return wrong != 0;
+}
+
+#if defined(CONFIG_WS2812_EMUL) && defined(CONFIG_WS2812_BACKEND_SPI)
+// Emulated chain behind the segment holding chain position index, and the
+// position within it
+static const struct emul *segment_target(int index, int *local) {
+    struct ws2812_segment_info info;
+
+    for (int s = 0; ws2812_get_segment(s, &info) == 0; s++) {
+        if (index >= info.first && index < info.first + info.count) {
+            *local = index - info.first;
+            return emul_get_binding(info.name);
+        }
+    }
+    return NULL;
+}
+
+// Send a known frame and compare what the emulated chain latched.
+// Returns the number of failures (call with matrix_mutex held).
+static int bench_check_wire(void) {
+    struct ws2812_segment_info info;
+    struct ws2812_emul_frame f;
+    uint32_t frame_ns = 0;
+    int failed = 0;
+    bool gamma = ws2812_get_gamma();
+    int wrong = 0;
+
+    // Compare raw colors: full brightness, no gamma
+    ws2812_set_gamma(false);
+    for (int y = 0; y < MATRIX_HEIGHT; y++) {
+        for (int x = 0; x < MATRIX_WIDTH; x++) {
+            ws2812_set_pixel(x, y, hsv_to_rgb(x * 16 + y, 255 - y * 8, 255));
+        }
+    }
+    ws2812_invalidate();
+    ws2812_update();
+    ws2812_sync();
+
+    for (int s = 0; ws2812_get_segment(s, &info) == 0; s++) {
+        const struct emul *target = emul_get_binding(info.name);
+
+        if (target == NULL || ws2812_emul_last_frame(target, &f) < 0) {
+            printk("  wire: no frame received on %s\n", info.name);
+            failed++;
+            continue;
+        }
+
+        printk("  wire: %s: %u LEDs, %u bad / %u marginal symbols, %u stalls\n", info.name,
+               f.leds, f.bad_symbols, f.marginal_symbols, f.stalls);
+        printk("  wire: %s: %u ns on the wire (lead %u, trail %u)\n", info.name, f.wire_ns,
+               f.lead_ns, f.trail_ns);
+        failed += (f.bad_symbols != 0) + (f.leds != info.count);
+        frame_ns = MAX(frame_ns, f.wire_ns);
+    }
+
+#ifdef CONFIG_WS2812_TRUNCATE
+    // Change the first LED of the top row: the frame should stop right after
+    // it, and the comparison below checks that the LEDs past the cut kept
+    // the full frame. Twice, so that with double buffering both buffers are
+    // past the full frame.
+    for (int x = 0; x < MATRIX_WIDTH; x++) {
+        int index = ws2812_chain_index(x, 0);
+        const struct emul *target;
+        int local;
+
+        if (index < 0) {
+            continue;
+        }
+        for (int i = 0; i < 2; i++) {
+            rgb_t c = ws2812_get_pixel(x, 0);
+
+            ws2812_set_pixel(x, 0, (rgb_t){ .g = ~c.g, .r = c.r, .b = c.b });
+            ws2812_update();
+        }
+        ws2812_sync();
+
+        target = segment_target(index, &local);
+        if (target == NULL || ws2812_emul_last_frame(target, &f) < 0) {
+            failed++;
+            break;
+        }
+        printk("  wire: truncated frame: %u LEDs, LED %d changed\n", f.leds, index);
+        failed += (f.bad_symbols != 0) + (f.leds != local + 1);
+        break;
+    }
+#endif
+
+    for (int y = 0; y < MATRIX_HEIGHT; y++) {
+        for (int x = 0; x < MATRIX_WIDTH; x++) {
+            int index = ws2812_chain_index(x, y);
+            const struct emul *target;
+            rgb_t want = ws2812_get_pixel(x, y);
+            rgb_t got;
+            int local;
+
+            if (index < 0) {
+                continue;
+            }
+            target = segment_target(index, &local);
+            if (target == NULL || ws2812_emul_get_led(target, local, &got) < 0) {
+                continue;
+            }
+            wrong += memcmp(&want, &got, sizeof(rgb_t)) != 0;
+        }
+    }
+    ws2812_set_gamma(gamma);
+
+    // Segments transfer side by side, so the longest one sets the frame time
+    printk("  wire: %d segment(s), %d LEDs wrong, frame %u ns + %d us latch\n",
+           ws2812_num_segments(), wrong, frame_ns, CONFIG_WS2812_EMUL_LATCH_US);
+
+    return failed + (wrong != 0);
+}
+#endif
+
+#ifdef CONFIG_WS2812_BACKEND_NULL
+// Send a known frame and compare the capture with the framebuffer.
+// Returns 1 if any LED differs (call with matrix_mutex held).
+static int bench_check_capture(void) {
+    const rgb_t *leds;
+    uint32_t frames = ws2812_capture_get(&leds);
+    bool gamma = ws2812_get_gamma();
+    int wrong = 0;
+
+    // Compare raw colors: full brightness, no gamma
+    ws2812_set_gamma(false);
+    for (int y = 0; y < MATRIX_HEIGHT; y++) {
+        for (int x = 0; x < MATRIX_WIDTH; x++) {
+            ws2812_set_pixel(x, y, hsv_to_rgb(x * 16 + y, 255 - y * 8, 255));
+        }
+    }
+    ws2812_update();
+    frames = ws2812_capture_get(&leds) - frames;
+
+    for (int y = 0; y < MATRIX_HEIGHT; y++) {
+        for (int x = 0; x < MATRIX_WIDTH; x++) {
+            int index = ws2812_chain_index(x, y);
+            rgb_t want = ws2812_get_pixel(x, y);
+
+            if (index >= 0) {
+                wrong += memcmp(&want, &leds[index], sizeof(rgb_t)) != 0;
+            }
+        }
+    }
+    ws2812_set_gamma(gamma);
+
+    printk("  capture: %u frame(s), %d LEDs wrong\n", frames, wrong);
+    return frames != 1 || wrong != 0;
+}
+#endif
+
+// Full frames through the output backend: time in ws2812_update() (what
+// the drawing thread pays), then until the frame is out, against the
+// nominal wire time. The update time is checked against the
+// "backend_<name>" budget. Call with matrix_mutex held.
+static int bench_check_backend(void) {
+    char name[40];
+    uint64_t update_ns = 0;
+    uint64_t out_ns = 0;
+    uint32_t budget;
+    uint32_t ns;
+
+    snprintk(name, sizeof(name), "backend_%s", ws2812_backend.name);
+    ws2812_sync();
+    for (int i = 0; i < BENCH_ITERS; i++) {
+        ws2812_fill(bench_color(i));
+        ws2812_invalidate();
+
+        bench_stamp_t start = bench_now();
+        ws2812_update();
+        update_ns += bench_elapsed_ns(start);
+
+        start = bench_now();
+        ws2812_sync();
+        out_ns += bench_elapsed_ns(start);
+    }
+
+    ns = update_ns / BENCH_ITERS;
+    budget = bench_budget(name);
+    printk("  %-28s %8u ns/frame in update, %u ns more until out, wire %u ns  budget %8u  %s\n",
+           name, ns, (uint32_t)(out_ns / BENCH_ITERS), ws2812_backend.frame_ns(), budget,
+           budget != 0 && ns > budget ? "OVER" : "ok");
+    return budget != 0 && ns > budget;
+}
+
+#ifdef CONFIG_WS2812_STREAM
+static int run_stream_chunk(int i) {
+    ws2812_bench_stream_chunk(i);
+    return 1;
+}
+
+// Streaming only works if chunk k is encoded before chunk k-1 has left the
+// wire. Returns 1 if the encoder is slower than the SPI clock.
+static int bench_check_stream(void) {
+    struct ws2812_stream_info info;
+    uint32_t ns = bench_run(&(const struct bench_case){ "stream_chunk", NULL, run_stream_chunk });
+    bool behind;
+
+    ws2812_stream_get_info(&info);
+    behind = ns >= info.chunk_wire_ns;
+    printk("  %-28s %8u ns/chunk  wire %8u ns/chunk  %s (%u%% of the wire time)\n",
+           "stream_chunk", ns, info.chunk_wire_ns, behind ? "BEHIND" : "ahead",
+           (uint32_t)((uint64_t)ns * 100 / info.chunk_wire_ns));
+    return behind;
+}
+#endif
+
+int ws2812_bench_suite_run(void) {
+    int failed = 0;
+
+    printk("WS2812 benchmark: %d x %d LEDs, %d rounds\n", MATRIX_WIDTH, MATRIX_HEIGHT,
+           BENCH_ITERS);
+
+    // The patterns and the demo share matrix_mutex with nothing yet, but
+    // take it anyway so the timings include what the real callers pay
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+    for (int i = 0; i < ARRAY_SIZE(cases); i++) {
+        failed += bench_check(&cases[i]);
+    }
+#ifdef CONFIG_WS2812_PATTERNS
+    // Budgets are per pattern, "pattern_<name>"
+    STRUCT_SECTION_FOREACH(ws2812_pattern, p) {
+        char name[40];
+
+        snprintk(name, sizeof(name), "pattern_%s", p->name);
+        bench_pattern = p;
+        failed += bench_check(&(const struct bench_case){ name, setup_pattern, run_pattern });
+    }
+#endif
+#ifdef CONFIG_WS2812_CLIP
+    // Budgets are per clip, "clip_<name>", in ns per decoded frame
+    STRUCT_SECTION_FOREACH(ws2812_clip, c) {
+        char name[40];
+
+        snprintk(name, sizeof(name), "clip_%s", c->name);
+        bench_clip = c;
+        failed += bench_check(&(const struct bench_case){ name, setup_clip, run_clip });
+    }
+#endif
+#ifdef CONFIG_WS2812_STREAM
+    failed += bench_check_stream();
+#endif
+    failed += bench_check_kernels();
+#if defined(CONFIG_WS2812_EMUL) && defined(CONFIG_WS2812_BACKEND_SPI)
+    failed += bench_check_wire();
+#endif
+#ifdef CONFIG_WS2812_BACKEND_NULL
+    failed += bench_check_capture();
+#endif
+    failed += bench_check_backend();
+    ws2812_clear();
+    ws2812_update();
+    k_mutex_unlock(&matrix_mutex);
+
+    uint32_t frame_ns = bench_run(&(const struct bench_case){ "quadrant", NULL, run_quadrant });
+    uint32_t fps = frame_ns ? NSEC_PER_SEC / frame_ns : 0;
+    uint32_t min_fps = bench_budget("quadrant");
+    bool under = min_fps != 0 && fps < min_fps;
+
+    printk("  %-28s %8u fps   (%u ns/frame)   minimum %8u  %s\n", "quadrant", fps, frame_ns,
+           min_fps, under ? "UNDER" : "ok");
+    failed += under;
+
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+    ws2812_clear();
+    ws2812_update();
+    k_mutex_unlock(&matrix_mutex);
+
+    if (failed) {
+        printk("BENCH FAIL: %d case(s) out of budget\n", failed);
+    } else {
+        printk("BENCH PASS\n");
+    }
+    return failed;
+}
+
+#endif /* CONFIG_WS2812_BENCH_SUITE */
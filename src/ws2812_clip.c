@@ -0,0 +1,257 @@
+/*
+ * Clip player
+ *
+ * Decodes compressed clips (format in ws2812_clip.h) from flash straight
+ * into the framebuffer. Key frame runs become row writes and fills; delta
+ * runs XOR onto the pixels already there, and zero runs are skipped
+ * without touching them. Either way only changed LEDs are marked dirty.
+ * The player itself is a few words of state, whatever the clip size.
+ */
+
+#include "ws2812_clip.h"
+#include <string.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/byteorder.h>
+#ifdef CONFIG_WS2812_PATTERNS
+#include "patterns.h"
+#endif
+#ifdef CONFIG_WS2812_LAYERS
+#include "ws2812_layer.h"
+#endif
+
+LOG_MODULE_REGISTER(ws2812_clip, LOG_LEVEL_INF);
+
+#ifdef CONFIG_WS2812_CLIP
+
+#define HEADER_SIZE       8
+#define FRAME_HEADER_SIZE 5
+#define RUN_REPEAT        0x80
+
+int ws2812_clip_open(struct ws2812_clip_player *player, const uint8_t *data, size_t size) {
+    if (size < HEADER_SIZE || data[0] != 'W' || data[1] != 'C' ||
+        data[2] != WS2812_CLIP_VERSION) {
+        LOG_ERR("Not a version %d clip", WS2812_CLIP_VERSION);
+        return -EINVAL;
+    }
+    if (data[4] != MATRIX_WIDTH || data[5] != MATRIX_HEIGHT) {
+        LOG_ERR("Clip is %ux%u, the matrix is %dx%d", data[4], data[5], MATRIX_WIDTH,
+                MATRIX_HEIGHT);
+        return -EINVAL;
+    }
+
+    player->data = data;
+    player->size = size;
+    player->pos = HEADER_SIZE;
+    player->frames = sys_get_le16(&data[6]);
+    player->frame = 0;
+    return player->frames ? 0 : -EINVAL;
+}
+
+// Put n pixels from (*x, *y) on, row by row, and advance the position.
+// src moves on by src_step pixels per pixel (0 repeats one pixel).
+static void put_pixels(bool delta, int *x, int *y, const rgb_t *src, int src_step, int n) {
+    bool zero = src_step == 0 && (src->g | src->r | src->b) == 0;
+
+    while (n > 0) {
+        int len = MIN(n, MATRIX_WIDTH - *x);
+
+        if (!delta) {
+            if (src_step) {
+                ws2812_write_row(*x, *y, src, len);
+            } else {
+                ws2812_fill_rect(*x, *y, len, 1, *src);
+            }
+        } else if (!zero) {
+            for (int i = 0; i < len; i++) {
+                const rgb_t *d = &src[i * src_step];
+                rgb_t c = ws2812_get_pixel(*x + i, *y);
+
+                c.g ^= d->g;
+                c.r ^= d->r;
+                c.b ^= d->b;
+                ws2812_set_pixel(*x + i, *y, c);
+            }
+        }
+
+        src += len * src_step;
+        n -= len;
+        *x += len;
+        if (*x == MATRIX_WIDTH) {
+            *x = 0;
+            (*y)++;
+        }
+    }
+}
+
+int ws2812_clip_next(struct ws2812_clip_player *player) {
+    if (player->frame == player->frames) {
+        player->frame = 0;
+        player->pos = HEADER_SIZE;
+    }
+    if (player->size - player->pos < FRAME_HEADER_SIZE) {
+        return -EBADMSG;
+    }
+
+    const uint8_t *f = player->data + player->pos;
+    uint16_t duration = sys_get_le16(&f[1]);
+    uint16_t len = sys_get_le16(&f[3]);
+    const uint8_t *run = f + FRAME_HEADER_SIZE;
+    const uint8_t *end = run + len;
+    bool delta = f[0] == WS2812_CLIP_DELTA;
+    int left = NUM_LEDS;
+    int x = 0, y = 0;
+
+    if (f[0] > WS2812_CLIP_DELTA || len > player->size - player->pos - FRAME_HEADER_SIZE) {
+        return -EBADMSG;
+    }
+
+    while (run < end) {
+        uint8_t c = *run++;
+        bool repeat = c >= RUN_REPEAT;
+        int n = repeat ? c - RUN_REPEAT + 1 : c + 1;
+        int bytes = repeat ? sizeof(rgb_t) : n * sizeof(rgb_t);
+
+        if (n > left || end - run < bytes) {
+            return -EBADMSG;
+        }
+        put_pixels(delta, &x, &y, (const rgb_t *)run, !repeat, n);
+        run += bytes;
+        left -= n;
+    }
+    if (left != 0) {
+        return -EBADMSG;
+    }
+
+    player->pos += FRAME_HEADER_SIZE + len;
+    player->frame++;
+    return duration;
+}
+
+const struct ws2812_clip *ws2812_clip_find(const char *name) {
+    STRUCT_SECTION_FOREACH(ws2812_clip, c) {
+        if (strcmp(c->name, name) == 0) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+// Looping playback on the system work queue, on absolute deadlines so the
+// frame durations add up without drift. playing is set under matrix_mutex,
+// so a producer that sees NULL there draws before the clip's next frame.
+static struct ws2812_clip_player player;
+static const struct ws2812_clip *playing;
+static k_ticks_t deadline;
+
+// Hand the matrix back, blank, so the producers redraw it from scratch
+static void clip_release(void) {
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+    playing = NULL;
+    ws2812_clear();
+#ifdef CONFIG_WS2812_LAYERS
+    ws2812_layers_hold(false);
+#endif
+    ws2812_update();
+    k_mutex_unlock(&matrix_mutex);
+}
+
+static void clip_work_handler(struct k_work *work) {
+    int ms;
+
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+    ms = ws2812_clip_next(&player);
+    if (ms >= 0) {
+        ws2812_update();
+    }
+    k_mutex_unlock(&matrix_mutex);
+
+    if (ms < 0) {
+        LOG_ERR("Clip %s: frame %u is corrupt, stopping", playing->name, player.frame);
+        clip_release();
+        return;
+    }
+
+    // Frames are deltas, so none can be skipped: if behind, just carry on
+    deadline = MAX(deadline + k_ms_to_ticks_ceil64(ms), k_uptime_ticks());
+    k_work_schedule(k_work_delayable_from_work(work), K_TIMEOUT_ABS_TICKS(deadline));
+}
+
+static K_WORK_DELAYABLE_DEFINE(clip_work, clip_work_handler);
+
+int ws2812_clip_play(const struct ws2812_clip *clip) {
+    struct k_work_sync sync;
+    int ret = 0;
+
+    k_work_cancel_delayable_sync(&clip_work, &sync);
+    if (clip != NULL) {
+#ifdef CONFIG_WS2812_PATTERNS
+        ws2812_pattern_run(NULL, 0);
+#endif
+        ret = ws2812_clip_open(&player, clip->data, clip->size);
+    }
+    if (clip == NULL || ret < 0) {
+        if (playing != NULL) {
+            LOG_INF("Clip %s stopped", playing->name);
+            clip_release();
+        }
+        return ret;
+    }
+
+    // Claim the matrix before the first frame is drawn
+#ifdef CONFIG_WS2812_LAYERS
+    ws2812_layers_hold(true);
+#endif
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+    playing = clip;
+    k_mutex_unlock(&matrix_mutex);
+
+    deadline = k_uptime_ticks();
+    k_work_schedule(&clip_work, K_NO_WAIT);
+    LOG_INF("Playing clip %s: %u frames, %u bytes", clip->name, player.frames,
+            (unsigned int)clip->size);
+    return 0;
+}
+
+const struct ws2812_clip *ws2812_clip_playing(void) {
+    return playing;
+}
+
+#ifdef CONFIG_WS2812_SHELL
+static int cmd_clip_list(const struct shell *sh, size_t argc, char **argv) {
+    STRUCT_SECTION_FOREACH(ws2812_clip, c) {
+        uint16_t frames = c->size >= HEADER_SIZE ? sys_get_le16(&c->data[6]) : 0;
+        uint32_t raw = (uint32_t)frames * NUM_LEDS * sizeof(rgb_t);
+
+        shell_print(sh, "%c %-16s %5u frames %7u bytes (%u%% of raw)", c == playing ? '*' : ' ',
+                    c->name, frames, (unsigned int)c->size,
+                    raw ? (unsigned int)((uint64_t)c->size * 100 / raw) : 0);
+    }
+    return 0;
+}
+
+static int cmd_clip_play(const struct shell *sh, size_t argc, char **argv) {
+    const struct ws2812_clip *c = ws2812_clip_find(argv[1]);
+
+    if (c == NULL) {
+        shell_error(sh, "No clip %s (see \"ws2812 clip list\")", argv[1]);
+        return -ENOENT;
+    }
+    return ws2812_clip_play(c);
+}
+
+static int cmd_clip_stop(const struct shell *sh, size_t argc, char **argv) {
+    return ws2812_clip_play(NULL);
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_clip,
+    SHELL_CMD(list, NULL, "List built-in clips", cmd_clip_list),
+    SHELL_CMD_ARG(play, NULL, "<name>  Play a clip in a loop", cmd_clip_play, 2, 0),
+    SHELL_CMD(stop, NULL, "Stop the clip", cmd_clip_stop),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_SUBCMD_ADD((ws2812), clip, &sub_clip, "Compressed animation clips", NULL, 1, 0);
+#endif
+
+#endif /* CONFIG_WS2812_CLIP */
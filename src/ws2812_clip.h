@@ -0,0 +1,81 @@
+#ifndef WS2812_CLIP_H
+#define WS2812_CLIP_H
+
+#include "ws2812.h"
+#include <zephyr/sys/iterable_sections.h>
+
+// Canned animations ("clips") kept in flash as compressed frames and
+// decoded straight into the framebuffer, one frame at a time. Clips are
+// made on the host by scripts/ws2812_clip.py, usually through the
+// ws2812_clip() CMake function (cmake/ws2812_clip.cmake), which also
+// registers them here.
+//
+// Format, little endian:
+//
+//   header  'W' 'C' version(1) flags(0) width height frames(u16)
+//   frame   type(u8) duration_ms(u16) length(u16) runs[length]
+//
+// A frame's runs cover width * height pixels, row by row from the
+// top-left corner. A run starts with a control byte c:
+//
+//   c < 0x80    c + 1 pixels follow, 3 bytes each in rgb_t order (G R B)
+//   c >= 0x80   one pixel follows, repeated c - 0x7f times
+//
+// In a key frame (type 0) the pixels are colors. In a delta frame (type 1)
+// they are XORed onto the previous frame, so unchanged pixels are zero and
+// a repeated zero leaves its pixels alone. The first frame is a key frame.
+
+#define WS2812_CLIP_VERSION 1
+
+enum ws2812_clip_frame_type {
+    WS2812_CLIP_KEY,
+    WS2812_CLIP_DELTA,
+};
+
+// A clip built into the image
+struct ws2812_clip {
+    const char *name;
+    const uint8_t *data;
+    size_t size;
+};
+
+#define WS2812_CLIP_DEFINE(_name, _data)                                        \
+    const STRUCT_SECTION_ITERABLE(ws2812_clip, ws2812_clip_##_name) = {        \
+        .name = #_name, .data = (_data), .size = sizeof(_data),                 \
+    }
+
+// Decoding position in a clip. Playback needs nothing else: the previous
+// frame is whatever the framebuffer holds.
+struct ws2812_clip_player {
+    const uint8_t *data;
+    size_t size;
+    size_t pos;         // Offset of the next frame
+    uint16_t frames;
+    uint16_t frame;     // Index of the next frame
+};
+
+// Check the clip header against the matrix and rewind to the first frame.
+// -EINVAL if it is not a clip or was made for another matrix size.
+int ws2812_clip_open(struct ws2812_clip_player *player, const uint8_t *data, size_t size);
+
+// Decode the next frame into the framebuffer (matrix_mutex held), wrapping
+// to the first frame after the last. Only pixels that change are written,
+// so the update after it only sends those. Returns how long to show the
+// frame in ms, or -EBADMSG if the frame is corrupt.
+int ws2812_clip_next(struct ws2812_clip_player *player);
+
+// Look a clip up by name; NULL if it isn't built in
+const struct ws2812_clip *ws2812_clip_find(const char *name);
+
+// Play clip in a loop (NULL stops it) from the system work queue. Stops a
+// running pattern, since both draw the whole matrix. Delta frames need the
+// matrix to themselves: while a clip plays the layer compositor is held
+// off and other producers must not draw into the framebuffer (see
+// ws2812_clip_playing()). Stopping blanks the matrix for them to redraw.
+int ws2812_clip_play(const struct ws2812_clip *clip);
+
+// Clip being played, or NULL. Producers that draw into the framebuffer
+// check it with matrix_mutex held and skip their frame while it is set.
+const struct ws2812_clip *ws2812_clip_playing(void);
+
+#endif /* WS2812_CLIP_H */
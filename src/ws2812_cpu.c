@@ -0,0 +1,209 @@
+/*
+ * Thread CPU share sampler
+ *
+ * Each sample walks the thread list once and turns every thread's
+ * execution cycle counter into the cycles it ran since the previous
+ * sample, kept in a ring of CONFIG_WS2812_CPU_SLOTS slots with a running
+ * sum, next to a ring of the wall time between samples. A share is then
+ * one division of two window sums. Threads stay in the table in
+ * k_thread_foreach_unlocked() order, so each one is found at the next
+ * position; only a thread created or gone since the last sample costs a
+ * search.
+ * The sampler times itself into a third ring so its own share is known.
+ */
+
+#include "ws2812_cpu.h"
+#include <string.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+
+LOG_MODULE_REGISTER(ws2812_cpu, LOG_LEVEL_INF);
+
+#ifdef CONFIG_WS2812_CPU
+
+#define SLOTS       CONFIG_WS2812_CPU_SLOTS
+#define MAX_THREADS CONFIG_WS2812_CPU_MAX_THREADS
+
+struct cpu_entry {
+    const struct k_thread *thread;
+    uint64_t last;          // Execution cycles at the last sample
+    uint64_t sum;           // delta[] summed
+    uint32_t delta[SLOTS];  // Cycles run in each slot
+    int8_t prio;
+};
+
+static struct cpu_entry entries[MAX_THREADS];
+static int num_entries;
+static int visited;
+static bool overflow;
+
+// Wall cycles between samples, and the cost of each sample
+static uint32_t elapsed[SLOTS];
+static uint32_t cost[SLOTS];
+static uint64_t elapsed_sum;
+static uint64_t cost_sum;
+static uint32_t last_now;
+static int slot;
+static bool started;
+
+static K_MUTEX_DEFINE(cpu_lock);
+
+static void ring_put(uint32_t *ring, uint64_t *sum, uint32_t value) {
+    *sum -= ring[slot];
+    ring[slot] = value;
+    *sum += value;
+}
+
+static void visit_thread(const struct k_thread *thread, void *user_data) {
+    k_thread_runtime_stats_t st;
+    struct cpu_entry *e;
+    bool fresh = false;
+
+    if (visited == MAX_THREADS) {
+        overflow = true;
+        return;
+    }
+
+    e = &entries[visited];
+
+    if (visited >= num_entries || e->thread != thread) {
+        // The thread list changed: look further on, else start an entry
+        // here and keep the one it replaces for a later match if there
+        // is room
+        int i = visited + 1;
+
+        while (i < num_entries && entries[i].thread != thread) {
+            i++;
+        }
+        if (i < num_entries) {
+            struct cpu_entry tmp = *e;
+
+            *e = entries[i];
+            entries[i] = tmp;
+        } else {
+            if (visited < num_entries && num_entries < MAX_THREADS) {
+                entries[num_entries++] = *e;
+            }
+            memset(e, 0, sizeof(*e));
+            e->thread = thread;
+            fresh = true;
+        }
+        num_entries = MAX(num_entries, visited + 1);
+    }
+
+    k_thread_runtime_stats_get((k_tid_t)thread, &st);
+    // A counter that went backwards belongs to a new thread in a reused
+    // struct k_thread: drop the old one's history and start afresh
+    if (!fresh && st.execution_cycles < e->last) {
+        memset(e, 0, sizeof(*e));
+        e->thread = thread;
+        fresh = true;
+    }
+    ring_put(e->delta, &e->sum, fresh ? 0 : (uint32_t)MIN(st.execution_cycles - e->last,
+                                                          UINT32_MAX));
+    e->last = st.execution_cycles;
+    e->prio = k_thread_priority_get((k_tid_t)thread);
+    visited++;
+}
+
+int ws2812_cpu_sample(void) {
+    int ret;
+
+    k_mutex_lock(&cpu_lock, K_FOREVER);
+    uint32_t start = k_cycle_get_32();
+
+    slot = (slot + 1) % SLOTS;
+    ring_put(elapsed, &elapsed_sum, started ? start - last_now : 0);
+    last_now = start;
+    started = true;
+
+    visited = 0;
+    overflow = false;
+    // Unlocked: the stats call takes its own lock, and cpu_lock guards the
+    // table
+    k_thread_foreach_unlocked(visit_thread, NULL);
+    // Whatever was not visited has exited
+    num_entries = visited;
+    ret = overflow ? -ENOMEM : visited;
+
+    ring_put(cost, &cost_sum, k_cycle_get_32() - start);
+    k_mutex_unlock(&cpu_lock);
+    return ret;
+}
+
+static uint16_t permille(uint64_t part, uint64_t whole) {
+    return whole ? (uint16_t)MIN(part * 1000 / whole, 1000) : 0;
+}
+
+int ws2812_cpu_get(struct ws2812_cpu_thread *threads, int max, struct ws2812_cpu_summary *sum) {
+    int n = 0;
+
+    k_mutex_lock(&cpu_lock, K_FOREVER);
+    if (sum != NULL) {
+        memset(sum, 0, sizeof(*sum));
+        sum->window_us = (uint32_t)k_cyc_to_us_floor64(elapsed_sum);
+        sum->threads = num_entries;
+        sum->overhead_permille = permille(cost_sum, elapsed_sum);
+        sum->sample_us = k_cyc_to_us_floor32(cost[slot]);
+    }
+
+    for (int i = 0; i < num_entries; i++) {
+        const struct cpu_entry *e = &entries[i];
+        uint16_t share = permille(e->sum, elapsed_sum);
+
+        if (sum != NULL) {
+            int p = e->prio - K_HIGHEST_THREAD_PRIO;
+
+            sum->prio_permille[p] = MIN(sum->prio_permille[p] + share, 1000);
+            sum->prio_threads[p]++;
+        }
+        if (n < max) {
+            threads[n++] = (struct ws2812_cpu_thread){
+                .thread = e->thread,
+#ifdef CONFIG_THREAD_NAME
+                .name = k_thread_name_get((k_tid_t)e->thread),
+#endif
+                .prio = e->prio,
+                .permille = share,
+            };
+        }
+    }
+    k_mutex_unlock(&cpu_lock);
+    return n;
+}
+
+#ifdef CONFIG_WS2812_SHELL
+static int cmd_cpu(const struct shell *sh, size_t argc, char **argv) {
+    static struct ws2812_cpu_thread threads[MAX_THREADS];
+    struct ws2812_cpu_summary sum;
+    int ret = ws2812_cpu_sample();
+    int n = ws2812_cpu_get(threads, ARRAY_SIZE(threads), &sum);
+
+    shell_print(sh, "%-20s %5s %7s", "Thread", "prio", "CPU");
+    for (int i = 0; i < n; i++) {
+        shell_print(sh, "%-20s %5d %3u.%u%%",
+                    threads[i].name && threads[i].name[0] ? threads[i].name : "(unnamed)",
+                    threads[i].prio, threads[i].permille / 10, threads[i].permille % 10);
+    }
+    if (ret == -ENOMEM) {
+        shell_warn(sh, "More than %d threads; raise CONFIG_WS2812_CPU_MAX_THREADS", MAX_THREADS);
+    }
+
+    shell_print(sh, "By priority:");
+    for (int p = 0; p < WS2812_CPU_PRIOS; p++) {
+        if (sum.prio_threads[p]) {
+            shell_print(sh, "  %3d: %3u.%u%% (%u thread%s)", p + K_HIGHEST_THREAD_PRIO,
+                        sum.prio_permille[p] / 10, sum.prio_permille[p] % 10,
+                        sum.prio_threads[p], sum.prio_threads[p] == 1 ? "" : "s");
+        }
+    }
+    shell_print(sh, "Window %u ms; sampler %u.%u%% (%u us per sample)%s", sum.window_us / 1000,
+                sum.overhead_permille / 10, sum.overhead_permille % 10, sum.sample_us,
+                sum.overhead_permille >= 10 ? ", over 1%" : "");
+    return 0;
+}
+
+SHELL_SUBCMD_ADD((ws2812), cpu, NULL, "CPU share per thread and priority", cmd_cpu, 1, 0);
+#endif
+
+#endif /* CONFIG_WS2812_CPU */
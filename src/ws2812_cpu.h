@@ -0,0 +1,41 @@
+#ifndef WS2812_CPU_H
+#define WS2812_CPU_H
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+
+// CPU share of every thread, and of every priority level, over a sliding
+// window of the last CONFIG_WS2812_CPU_SLOTS samples. Each sample walks
+// the threads once with k_thread_foreach() and reads their execution
+// cycles with k_thread_runtime_stats_get(): O(threads), integer only, and
+// nothing runs between samples. The caller sets the pace, e.g. once per
+// frame of the priority visualizer pattern.
+
+// Priority levels, K_HIGHEST_THREAD_PRIO (index 0) to K_LOWEST_THREAD_PRIO
+#define WS2812_CPU_PRIOS (K_LOWEST_THREAD_PRIO - K_HIGHEST_THREAD_PRIO + 1)
+
+struct ws2812_cpu_thread {
+    const struct k_thread *thread;
+    const char *name;       // NULL without CONFIG_THREAD_NAME
+    int8_t prio;
+    uint16_t permille;      // Share of the window, 0-1000
+};
+
+struct ws2812_cpu_summary {
+    uint32_t window_us;     // Span of the window
+    uint16_t threads;       // Threads seen by the last sample
+    uint16_t overhead_permille;  // Sampling itself, share of the window
+    uint32_t sample_us;     // Last sample's cost
+    uint16_t prio_permille[WS2812_CPU_PRIOS];
+    uint8_t prio_threads[WS2812_CPU_PRIOS];
+};
+
+// Take a sample; returns the number of threads seen, or -ENOMEM if there
+// are more than CONFIG_WS2812_CPU_MAX_THREADS (the rest are left out)
+int ws2812_cpu_sample(void);
+
+// Copy out up to max threads, in k_thread_foreach() order, and the summary
+// (either may be NULL). Returns the number copied.
+int ws2812_cpu_get(struct ws2812_cpu_thread *threads, int max, struct ws2812_cpu_summary *sum);
+
+#endif /* WS2812_CPU_H */
@@ -0,0 +1,348 @@
+/*
+ * Emulated WS2812 chain for native_sim
+ *
+ * Sits on a zephyr,spi-emul-controller in place of the real strip and
+ * decodes every frame the driver sends the way the LEDs would: the MOSI
+ * bit stream is turned back into high/low pulse widths at the configured
+ * SPI clock, each pulse is classified against the WS2812 timing limits,
+ * and the resulting bits are shifted into the chain. Malformed and
+ * marginal symbols are counted, and the frame's exact time on the wire
+ * (padding included) and the reset gap before it are reported.
+ *
+ * A frame may arrive in several transfers (CONFIG_WS2812_STREAM chunks):
+ * as on the real chain, the next transfer continues the frame unless the
+ * line stayed low for the latch time in between, and the idle time counts
+ * as part of the current low phase.
+ *
+ * With CONFIG_WS2812_EMUL_WIRE_DELAY a transfer also takes its wire time
+ * in simulated time, so the driver's reset gap handling and frame rate
+ * behave as on hardware.
+ */
+
+#define DT_DRV_COMPAT zephyr_ws2812_spi_emul
+
+#include "ws2812_emul.h"
+#include <zephyr/device.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/drivers/spi_emul.h>
+#include <zephyr/shell/shell.h>
+
+#ifdef CONFIG_WS2812_EMUL
+
+struct ws2812_emul_cfg {
+    uint16_t chain_len;
+};
+
+// Bit-stream decoder state for one frame
+struct ws2812_emul_data;
+
+struct wire_decoder {
+    const struct ws2812_emul_cfg *cfg;
+    struct ws2812_emul_data *data;
+    struct ws2812_emul_frame *frame;
+    uint32_t bit_ps;                 // One SPI bit
+    uint32_t high, low;              // Current pulse, in SPI bits
+    uint32_t lead;                   // Zeros before the first pulse
+    bool started;
+    uint32_t led;
+    uint8_t chan;
+    uint8_t byte;
+    uint8_t nbits;
+};
+
+struct ws2812_emul_data {
+    rgb_t *leds;                     // chain_len, last latched colors
+    struct ws2812_emul_frame last;
+    uint32_t seq;
+    uint32_t end_cyc;                // When the previous transfer left the wire
+    struct wire_decoder dec;         // Frame in progress, may continue next transfer
+    struct ws2812_emul_frame cur;
+    struct k_spinlock lock;          // Guards last
+};
+
+static bool in_window(uint32_t ns, uint32_t lo, uint32_t hi) {
+    return ns >= lo && ns <= hi;
+}
+
+static bool near_edge(uint32_t ns, uint32_t lo, uint32_t hi) {
+    return ns < lo + CONFIG_WS2812_EMUL_GUARD_NS || ns + CONFIG_WS2812_EMUL_GUARD_NS > hi;
+}
+
+static void shift_bit(struct wire_decoder *d, uint8_t bit) {
+    d->byte = (d->byte << 1) | bit;
+    if (++d->nbits < 8) {
+        return;
+    }
+    d->nbits = 0;
+
+    if (d->led >= d->cfg->chain_len) {
+        // Would be passed on to whatever follows the chain
+        d->frame->extra_bits += 8;
+        return;
+    }
+
+    uint8_t *px = (uint8_t *)&d->data->leds[d->led];
+    px[d->chan] = d->byte;
+    if (++d->chan == 3) {
+        d->chan = 0;
+        d->led++;
+    }
+}
+
+// Classify one high pulse and the low after it. last is set for the final
+// pulse, whose low runs into the idle line and is not a limit violation.
+static void decode_symbol(struct wire_decoder *d, bool last) {
+    const struct ws2812_timing *lim = &ws2812_default_timing;
+    uint32_t high_ns = (uint64_t)d->high * d->bit_ps / 1000;
+    uint32_t low_ns = (uint64_t)d->low * d->bit_ps / 1000;
+    bool bad = false;
+    bool marginal = false;
+    uint8_t bit;
+
+    if (in_window(high_ns, lim->t0h_min_ns, lim->t0h_max_ns)) {
+        bit = 0;
+        marginal = near_edge(high_ns, lim->t0h_min_ns, lim->t0h_max_ns);
+    } else if (in_window(high_ns, lim->t1h_min_ns, lim->t1h_max_ns)) {
+        bit = 1;
+        marginal = near_edge(high_ns, lim->t1h_min_ns, lim->t1h_max_ns);
+    } else {
+        // The LED samples the line between the two windows
+        bit = high_ns > (lim->t0h_max_ns + lim->t1h_min_ns) / 2;
+        bad = true;
+    }
+
+    if (!last) {
+        uint32_t period_ns = high_ns + low_ns;
+
+        if (low_ns < lim->tl_min_ns || period_ns < lim->period_min_ns) {
+            bad = true;
+        } else if (period_ns > lim->period_max_ns) {
+            d->frame->stalls++;
+        } else if (low_ns < lim->tl_min_ns + CONFIG_WS2812_EMUL_GUARD_NS ||
+                   near_edge(period_ns, lim->period_min_ns, lim->period_max_ns)) {
+            marginal = true;
+        }
+    }
+
+    d->frame->bad_symbols += bad;
+    d->frame->marginal_symbols += marginal && !bad;
+    shift_bit(d, bit);
+}
+
+static void decode_byte(struct wire_decoder *d, uint8_t byte) {
+    for (int i = 7; i >= 0; i--) {
+        if (byte & BIT(i)) {
+            if (d->low > 0) {
+                decode_symbol(d, false);
+                d->high = 0;
+                d->low = 0;
+            }
+            d->high++;
+            d->started = true;
+        } else if (d->started) {
+            d->low++;
+        } else {
+            d->lead++;
+        }
+    }
+}
+
+// Fill in the per-frame totals for what has been decoded so far. Works on a
+// copy, so the last pulse can be closed off without ending the frame.
+static void frame_snapshot(const struct wire_decoder *dec, const struct ws2812_emul_frame *cur,
+                           struct ws2812_emul_frame *frame) {
+    struct wire_decoder d = *dec;
+
+    *frame = *cur;
+    d.frame = frame;
+    if (d.high > 0) {
+        decode_symbol(&d, true);
+    }
+
+    frame->leds = d.led;
+    frame->partial_bits = d.chan * 8 + d.nbits;
+    frame->lead_ns = (uint64_t)d.lead * d.bit_ps / 1000;
+    frame->trail_ns = (uint64_t)d.low * d.bit_ps / 1000;
+}
+
+static int ws2812_emul_io(const struct emul *target, const struct spi_config *config,
+                          const struct spi_buf_set *tx_bufs,
+                          const struct spi_buf_set *rx_bufs) {
+    const struct ws2812_emul_cfg *cfg = target->cfg;
+    struct ws2812_emul_data *data = target->data;
+    struct wire_decoder *d = &data->dec;
+    struct ws2812_emul_frame frame;
+    uint32_t start_cyc = k_cycle_get_32();
+    uint32_t total_bits = 0;
+    uint32_t gap_ns;
+
+    if (tx_bufs == NULL || config->frequency == 0) {
+        return -EINVAL;
+    }
+
+    uint32_t bit_ps = 1000000000u / (config->frequency / 1000);
+
+    if (data->seq == 0) {
+        gap_ns = UINT32_MAX;
+    } else if ((int32_t)(start_cyc - data->end_cyc) < 0) {
+        gap_ns = 0;  // Started before the previous transfer was out
+    } else {
+        gap_ns = k_cyc_to_ns_floor64(start_cyc - data->end_cyc);
+    }
+
+    // The line was low for the previous transfer's trailing bits plus the gap
+    uint64_t idle_ns = (uint64_t)d->low * d->bit_ps / 1000 + gap_ns;
+
+    if (data->seq == 0 || idle_ns >= CONFIG_WS2812_EMUL_LATCH_US * NSEC_PER_USEC ||
+        bit_ps != d->bit_ps) {
+        // The LEDs latched: this transfer starts a new frame
+        memset(&data->cur, 0, sizeof(data->cur));
+        data->cur.reset_ns = gap_ns;
+        data->cur.reset_ok = idle_ns >= CONFIG_WS2812_EMUL_LATCH_US * NSEC_PER_USEC;
+        *d = (struct wire_decoder){ .bit_ps = bit_ps };
+        data->seq++;
+    } else {
+        // Still the same frame: the idle line stretches the current low
+        uint32_t idle_bits = (uint64_t)gap_ns * 1000 / bit_ps;
+
+        if (d->started) {
+            d->low += idle_bits;
+        } else {
+            d->lead += idle_bits;
+        }
+        data->cur.max_gap_ns = MAX(data->cur.max_gap_ns, gap_ns);
+    }
+    d->cfg = cfg;
+    d->data = data;
+    d->frame = &data->cur;
+    data->cur.transfers++;
+
+    for (size_t i = 0; i < tx_bufs->count; i++) {
+        const uint8_t *buf = tx_bufs->buffers[i].buf;
+
+        for (size_t j = 0; j < tx_bufs->buffers[i].len; j++) {
+            decode_byte(d, buf[j]);
+        }
+        total_bits += tx_bufs->buffers[i].len * 8;
+    }
+
+    uint32_t wire_ns = (uint64_t)total_bits * bit_ps / 1000;
+    data->cur.wire_ns += wire_ns;
+    frame_snapshot(d, &data->cur, &frame);
+    frame.seq = data->seq;
+
+#ifdef CONFIG_WS2812_EMUL_WIRE_DELAY
+    k_busy_wait(DIV_ROUND_UP(wire_ns, NSEC_PER_USEC));
+    uint32_t end_cyc = k_cycle_get_32();
+#else
+    uint32_t end_cyc = start_cyc + k_ns_to_cyc_ceil32(wire_ns);
+#endif
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    data->end_cyc = end_cyc;
+    data->last = frame;
+    k_spin_unlock(&data->lock, key);
+
+    return 0;
+}
+
+int ws2812_emul_last_frame(const struct emul *target, struct ws2812_emul_frame *frame) {
+    struct ws2812_emul_data *data = target->data;
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    int ret = 0;
+
+    if (data->seq == 0) {
+        ret = -ENODATA;
+    } else {
+        *frame = data->last;
+    }
+
+    k_spin_unlock(&data->lock, key);
+    return ret;
+}
+
+int ws2812_emul_get_led(const struct emul *target, int index, rgb_t *color) {
+    const struct ws2812_emul_cfg *cfg = target->cfg;
+    struct ws2812_emul_data *data = target->data;
+
+    if (index < 0 || index >= cfg->chain_len) {
+        return -EINVAL;
+    }
+    *color = data->leds[index];
+    return 0;
+}
+
+static const struct spi_emul_api ws2812_emul_api = {
+    .io = ws2812_emul_io,
+};
+
+static int ws2812_emul_init(const struct emul *target, const struct device *parent) {
+    return 0;
+}
+
+#define WS2812_EMUL(n)                                                        \
+    static rgb_t ws2812_emul_leds_##n[DT_INST_PROP(n, chain_length)];         \
+    static struct ws2812_emul_data ws2812_emul_data_##n = {                   \
+        .leds = ws2812_emul_leds_##n,                                         \
+    };                                                                        \
+    static const struct ws2812_emul_cfg ws2812_emul_cfg_##n = {               \
+        .chain_len = DT_INST_PROP(n, chain_length),                           \
+    };                                                                        \
+    EMUL_DT_INST_DEFINE(n, ws2812_emul_init, &ws2812_emul_data_##n,           \
+                        &ws2812_emul_cfg_##n, &ws2812_emul_api, NULL);        \
+    DEVICE_DT_INST_DEFINE(n, NULL, NULL, NULL, NULL, POST_KERNEL,             \
+                          CONFIG_APPLICATION_INIT_PRIORITY, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(WS2812_EMUL)
+
+// Frames only reach the emulated chain through the SPI backend
+#if defined(CONFIG_WS2812_SHELL) && defined(CONFIG_WS2812_BACKEND_SPI)
+static void print_frame(const struct shell *sh, const struct ws2812_emul_frame *f) {
+    shell_print(sh, "Frame %u: %u LEDs latched, %u extra bits, %u partial bits", f->seq,
+                f->leds, f->extra_bits, f->partial_bits);
+    shell_print(sh, "  symbols: %u bad, %u marginal (guard %d ns), %u stalls",
+                f->bad_symbols, f->marginal_symbols, CONFIG_WS2812_EMUL_GUARD_NS, f->stalls);
+    shell_print(sh, "  wire:    %u ns (lead %u ns, trail %u ns)", f->wire_ns, f->lead_ns,
+                f->trail_ns);
+    if (f->transfers > 1) {
+        shell_print(sh, "  joined:  %u transfers, longest gap %u ns", f->transfers,
+                    f->max_gap_ns);
+    }
+    if (f->reset_ns == UINT32_MAX) {
+        shell_print(sh, "  reset:   first frame");
+    } else {
+        shell_print(sh, "  reset:   %u ns before the frame (%s, latch needs %d us)",
+                    f->reset_ns, f->reset_ok ? "ok" : "TOO SHORT", CONFIG_WS2812_EMUL_LATCH_US);
+    }
+}
+
+static int cmd_wire(const struct shell *sh, size_t argc, char **argv) {
+    struct ws2812_segment_info info;
+    struct ws2812_emul_frame f;
+    uint32_t frame_ns = 0;
+
+    // One emulated chain per driver segment
+    for (int s = 0; ws2812_get_segment(s, &info) == 0; s++) {
+        const struct emul *target = emul_get_binding(info.name);
+
+        shell_print(sh, "%s (LEDs %u-%u):", info.name, info.first,
+                    info.first + info.count - 1);
+        if (target == NULL || ws2812_emul_last_frame(target, &f) < 0) {
+            shell_print(sh, "No frame received yet");
+            continue;
+        }
+        print_frame(sh, &f);
+        frame_ns = MAX(frame_ns, f.wire_ns);
+    }
+
+    if (ws2812_num_segments() > 1) {
+        shell_print(sh, "Frame time: %u ns (segments in parallel)", frame_ns);
+    }
+    return 0;
+}
+
+SHELL_SUBCMD_ADD((ws2812), wire, NULL, "Decode the last frame on the emulated chain",
+                 cmd_wire, 1, 0);
+#endif
+
+#endif /* CONFIG_WS2812_EMUL */
@@ -0,0 +1,32 @@
+#ifndef WS2812_EMUL_H
+#define WS2812_EMUL_H
+
+#include <zephyr/drivers/emul.h>
+#include "ws2812.h"
+
+// What the emulated chain saw in one SPI frame
+struct ws2812_emul_frame {
+    uint32_t seq;               // Frames received so far
+    uint32_t leds;              // LEDs that received all 24 bits
+    uint32_t extra_bits;        // Bits past the end of the chain
+    uint32_t partial_bits;      // Trailing bits that do not make a whole byte
+    uint32_t bad_symbols;       // High time fits neither bit, or low/period out of limits
+    uint32_t marginal_symbols;  // Valid, but within CONFIG_WS2812_EMUL_GUARD_NS of a limit
+    uint32_t stalls;            // Lows longer than the max period inside the frame
+    uint32_t transfers;         // SPI transfers the frame arrived in
+    uint32_t max_gap_ns;        // Longest idle time between those transfers
+    uint32_t wire_ns;           // All transfers at the SPI clock, padding included
+    uint32_t lead_ns;           // Idle time before the first symbol
+    uint32_t trail_ns;          // Low time after the last high pulse
+    uint32_t reset_ns;          // Idle time since the previous frame's last transfer
+    bool reset_ok;              // Line idle >= CONFIG_WS2812_EMUL_LATCH_US: reset_ns plus
+                                // the previous transfer's trailing low bits
+};
+
+// Report for the last frame. Returns -ENODATA before the first frame.
+int ws2812_emul_last_frame(const struct emul *target, struct ws2812_emul_frame *frame);
+
+// Color LED index latched from the last frame, in wire order
+int ws2812_emul_get_led(const struct emul *target, int index, rgb_t *color);
+
+#endif /* WS2812_EMUL_H */
@@ -0,0 +1,112 @@
+/*
+ * Entity engine
+ *
+ * Steps and draws runs of moving rectangles kept in a structure-of-arrays
+ * pool: the physics pass only touches positions, velocities and sizes, and
+ * drawing goes through one clipped rectangle fill per entity.
+ */
+
+#include "ws2812_entity.h"
+#include "ws2812_kernels.h"
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(ws2812_entity, LOG_LEVEL_INF);
+
+// Entities bounce when they come within half a pixel of a view edge and
+// restart a tenth of a pixel further in, so their truncated position always
+// stays inside the view
+#define EDGE    Q16(0.5)
+#define REBOUND Q16(0.1)
+
+#define NOT_DRAWN INT16_MIN
+
+int ws2812_entity_add(struct ws2812_entity_pool *pool, const struct ws2812_entity_view *view,
+                      const struct ws2812_entity_desc *desc) {
+    if (pool->count == pool->capacity) {
+        LOG_ERR("Entity pool full (%u entities)", pool->capacity);
+        return -ENOMEM;
+    }
+
+    int i = pool->count++;
+
+    pool->x[i] = desc->x;
+    pool->y[i] = desc->y;
+    pool->vx[i] = desc->vx;
+    pool->vy[i] = desc->vy;
+    pool->w[i] = desc->w;
+    pool->h[i] = desc->h;
+    pool->color[i] = desc->color;
+    pool->view[i] = view;
+    pool->drawn_x[i] = NOT_DRAWN;
+    pool->drawn_y[i] = NOT_DRAWN;
+    return i;
+}
+
+// Move along one axis and bounce off [EDGE, span - size + EDGE]
+static inline void step_axis(q16_t *pos, q16_t *vel, int span, int size) {
+    q16_t p = *pos + *vel;
+    q16_t hi = q16_from_int(span - size) + EDGE;
+
+    if (p <= EDGE || p >= hi) {
+        *vel = -*vel;
+        p = (p <= EDGE) ? EDGE + REBOUND : hi - REBOUND;
+    }
+    *pos = p;
+}
+
+// Fill a w x h rectangle at (x, y) in view coordinates, clipped to the view
+static void view_fill(const struct ws2812_entity_view *v, int x, int y, int w, int h,
+                      rgb_t color) {
+    int x0 = MAX(x, 0);
+    int y0 = MAX(y, 0);
+    int x1 = MIN(x + w, v->w);
+    int y1 = MIN(y + h, v->h);
+
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+#ifdef CONFIG_WS2812_LAYERS
+    struct ws2812_layer *layer = v->layer;
+
+    if (layer != NULL) {
+        rgb_t *row = &layer->draw[(v->y - layer->y + y0) * layer->w + v->x - layer->x + x0];
+
+        for (int yy = y0; yy < y1; yy++, row += layer->w) {
+            ws2812_kernel_fill(row, x1 - x0, color);
+        }
+        return;
+    }
+#endif
+
+    ws2812_fill_rect(v->x + x0, v->y + y0, x1 - x0, y1 - y0, color);
+}
+
+void ws2812_entity_update(struct ws2812_entity_pool *pool, int first, int count) {
+    const int end = MIN(first + count, pool->count);
+
+    for (int i = first; i < end; i++) {
+        step_axis(&pool->x[i], &pool->vx[i], pool->view[i]->w, pool->w[i]);
+        step_axis(&pool->y[i], &pool->vy[i], pool->view[i]->h, pool->h[i]);
+    }
+
+    // Erase entities that moved; the draw pass repaints the ones that didn't
+    for (int i = first; i < end; i++) {
+        int x = q16_to_int(pool->x[i]);
+        int y = q16_to_int(pool->y[i]);
+
+        if (pool->drawn_x[i] != NOT_DRAWN && (pool->drawn_x[i] != x || pool->drawn_y[i] != y)) {
+            view_fill(pool->view[i], pool->drawn_x[i], pool->drawn_y[i], pool->w[i], pool->h[i],
+                      (rgb_t){0, 0, 0});
+        }
+    }
+
+    for (int i = first; i < end; i++) {
+        int x = q16_to_int(pool->x[i]);
+        int y = q16_to_int(pool->y[i]);
+
+        view_fill(pool->view[i], x, y, pool->w[i], pool->h[i], pool->color[i]);
+        pool->drawn_x[i] = x;
+        pool->drawn_y[i] = y;
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef WS2812_ENTITY_H
+#define WS2812_ENTITY_H
+
+#include "ws2812.h"
+#include "ws2812_fixed.h"
+
+#ifdef CONFIG_WS2812_LAYERS
+#include "ws2812_layer.h"
+#endif
+
+// Moving rectangles (balls, particles, sprites without an image) bouncing
+// inside a viewport of the matrix.
+//
+// A pool keeps every property in its own array (structure of arrays), so
+// one ws2812_entity_update() pass steps a whole run of entities with tight
+// loops over a few arrays, then erases and redraws them clipped to their
+// viewports. Entities never move between pools or viewports.
+
+// Area an entity bounces in, in matrix coordinates. Entity positions are
+// relative to its top-left corner.
+struct ws2812_entity_view {
+    int16_t x, y;
+    uint8_t w, h;
+#ifdef CONFIG_WS2812_LAYERS
+    // Draw into this layer instead of the framebuffer; the view must lie
+    // within the layer's viewport
+    struct ws2812_layer *layer;
+#endif
+};
+
+struct ws2812_entity_pool {
+    uint16_t capacity;
+    uint16_t count;
+    q16_t *x, *y;           // Top-left corner, Q16.16 pixels within the view
+    q16_t *vx, *vy;         // Pixels per update
+    uint8_t *w, *h;         // Size in pixels
+    rgb_t *color;
+    const struct ws2812_entity_view **view;
+    int16_t *drawn_x, *drawn_y;  // Where it was last drawn, for erasing
+};
+
+// Define a pool with static storage for _capacity entities
+#define WS2812_ENTITY_POOL_DEFINE(_name, _capacity)                     \
+    static q16_t _name##_pos[4][_capacity];                             \
+    static uint8_t _name##_size[2][_capacity];                          \
+    static rgb_t _name##_color[_capacity];                              \
+    static const struct ws2812_entity_view *_name##_view[_capacity];   \
+    static int16_t _name##_drawn[2][_capacity];                         \
+    struct ws2812_entity_pool _name = {                                 \
+        .capacity = (_capacity),                                        \
+        .x = _name##_pos[0], .y = _name##_pos[1],                       \
+        .vx = _name##_pos[2], .vy = _name##_pos[3],                     \
+        .w = _name##_size[0], .h = _name##_size[1],                     \
+        .color = _name##_color, .view = _name##_view,                   \
+        .drawn_x = _name##_drawn[0], .drawn_y = _name##_drawn[1],       \
+    }
+
+// Initial state of a new entity
+struct ws2812_entity_desc {
+    q16_t x, y;
+    q16_t vx, vy;
+    uint8_t w, h;
+    rgb_t color;
+};
+
+// Add an entity to view; returns its index in the pool or -ENOMEM
+int ws2812_entity_add(struct ws2812_entity_pool *pool, const struct ws2812_entity_view *view,
+                      const struct ws2812_entity_desc *desc);
+
+// Move entities first..first+count-1 one step, bouncing off their view
+// edges, then erase them where they were drawn and draw them at their new
+// positions (all erases before all draws, so overlapping entities in the
+// run don't punch holes in each other). Draws into the framebuffer need
+// matrix_mutex held; runs that share a view or layer must be updated by
+// the same thread.
+void ws2812_entity_update(struct ws2812_entity_pool *pool, int first, int count);
+
+#endif /* WS2812_ENTITY_H */
@@ -0,0 +1,39 @@
+/*
+ * Fixed-point sine
+ *
+ * A quarter wave in flash, mirrored for the other three quadrants and
+ * linearly interpolated between entries: within 4 LSB of Q1.15.
+ */
+
+#include "ws2812_fixed.h"
+
+// sin(i * pi/128) in Q1.15, i = 0..64
+static const int16_t quarter_sine[65] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+    6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767,
+};
+
+int16_t sin16(uint16_t angle) {
+    // Bits 15-14: quadrant, 13-8: table step, 7-0: interpolation
+    uint16_t phase = angle & 0x3FFF;
+
+    if (angle & 0x4000) {
+        phase = 0x4000 - phase;  // Falling quarter: mirror in time
+    }
+
+    uint16_t i = phase >> 8;
+    int32_t frac = phase & 0xFF;
+    int32_t v = quarter_sine[i];
+
+    if (frac) {
+        v += ((quarter_sine[i + 1] - v) * frac) >> 8;
+    }
+    return (angle & 0x8000) ? -v : v;
+}
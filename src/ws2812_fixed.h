@@ -0,0 +1,64 @@
+#ifndef WS2812_FIXED_H
+#define WS2812_FIXED_H
+
+#include <zephyr/kernel.h>
+
+// Fixed-point helpers so patterns and ball physics need no FPU or libm.
+//
+// q16_t is Q16.16: positions and velocities in pixels. Q8 values are
+// uint8_t fractions where 256 means 1.0, used to scale and fade colors.
+// Angles are binary: 65536 (sin16) or 256 (sin8) is one full turn.
+
+typedef int32_t q16_t;
+
+#define Q16_ONE (1 << 16)
+
+// Constant x in Q16.16 (folded at compile time; x must be a constant)
+#define Q16(x) ((q16_t)((x) * Q16_ONE))
+
+// Constant fraction 0.0 <= x < 1.0 as a Q8 scale factor
+#define Q8(x) ((uint8_t)((x) * 256))
+
+static inline q16_t q16_from_int(int v) {
+    return (q16_t)v << 16;
+}
+
+// Round toward negative infinity
+static inline int q16_to_int(q16_t v) {
+    return v >> 16;
+}
+
+// Round to the nearest integer
+static inline int q16_round(q16_t v) {
+    return (v + Q16_ONE / 2) >> 16;
+}
+
+static inline q16_t q16_mul(q16_t a, q16_t b) {
+    return (q16_t)(((int64_t)a * b) >> 16);
+}
+
+// v * scale / 256
+static inline uint8_t scale8(uint8_t v, uint8_t scale) {
+    return (uint8_t)((v * scale) >> 8);
+}
+
+// a + b, saturating at 255
+static inline uint8_t qadd8(uint8_t a, uint8_t b) {
+    unsigned int sum = a + b;
+
+    return sum > 255 ? 255 : sum;
+}
+
+// Sine of a binary angle in Q1.15 (-32767..32767)
+int16_t sin16(uint16_t angle);
+
+static inline int16_t cos16(uint16_t angle) {
+    return sin16(angle + 16384);
+}
+
+// Sine of a binary angle mapped to 1..255, centered on 128
+static inline uint8_t sin8(uint8_t angle) {
+    return 128 + ((sin16(angle << 8) * 127 + 16384) >> 15);
+}
+
+#endif /* WS2812_FIXED_H */
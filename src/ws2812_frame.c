@@ -0,0 +1,110 @@
+/*
+ * Frame clock
+ *
+ * A k_timer ticks at the frame rate and wakes every registered client
+ * through its own semaphore, so producers and the committing display
+ * thread run in lock-step instead of drifting on independent k_msleep()
+ * periods. Each client wakes exactly once per tick; ticks that pass while
+ * a client is still busy are counted as missed deadlines.
+ */
+
+#include "ws2812_frame.h"
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+
+LOG_MODULE_REGISTER(ws2812_frame, LOG_LEVEL_INF);
+
+#ifdef CONFIG_WS2812_FRAME_CLOCK
+
+static struct ws2812_frame_client *clients[CONFIG_WS2812_FRAME_MAX_CLIENTS];
+static atomic_t num_clients;
+static atomic_t frame_seq;
+static K_MUTEX_DEFINE(register_lock);
+
+static void frame_tick(struct k_timer *timer) {
+    atomic_inc(&frame_seq);
+
+    int n = atomic_get(&num_clients);
+    for (int i = 0; i < n; i++) {
+        k_sem_give(&clients[i]->tick);
+    }
+}
+
+K_TIMER_DEFINE(frame_timer, frame_tick, NULL);
+
+void ws2812_frame_start(void) {
+    k_timeout_t period = K_USEC(USEC_PER_SEC / CONFIG_WS2812_FRAME_RATE);
+
+    k_timer_start(&frame_timer, period, period);
+    LOG_INF("Frame clock running at %d Hz", CONFIG_WS2812_FRAME_RATE);
+}
+
+int ws2812_frame_register(struct ws2812_frame_client *client, const char *name) {
+    k_mutex_lock(&register_lock, K_FOREVER);
+
+    int n = atomic_get(&num_clients);
+    if (n == ARRAY_SIZE(clients)) {
+        k_mutex_unlock(&register_lock);
+        LOG_ERR("No room for frame client %s (CONFIG_WS2812_FRAME_MAX_CLIENTS=%d)",
+                name, CONFIG_WS2812_FRAME_MAX_CLIENTS);
+        return -ENOMEM;
+    }
+
+    client->name = name;
+    k_sem_init(&client->tick, 0, 1);
+    client->frame = atomic_get(&frame_seq);
+    client->frames = 0;
+    client->missed = 0;
+
+    // Publish the slot before the timer can see it
+    clients[n] = client;
+    atomic_set(&num_clients, n + 1);
+
+    k_mutex_unlock(&register_lock);
+    return 0;
+}
+
+uint32_t ws2812_frame_wait(struct ws2812_frame_client *client) {
+    uint32_t now = atomic_get(&frame_seq);
+
+    if (now != client->frame) {
+        // Still working when the tick came: run late rather than wait
+        // another full frame. Drop the pending give for that tick.
+        client->missed += now - client->frame;
+        k_sem_take(&client->tick, K_NO_WAIT);
+    } else {
+        k_sem_take(&client->tick, K_FOREVER);
+        now = atomic_get(&frame_seq);
+        // Only possible if the client was starved after being woken
+        if (now - client->frame > 1) {
+            client->missed += now - client->frame - 1;
+        }
+    }
+
+    client->frame = now;
+    client->frames++;
+    return now;
+}
+
+uint32_t ws2812_frame_count(void) {
+    return atomic_get(&frame_seq);
+}
+
+#ifdef CONFIG_WS2812_SHELL
+static int cmd_frame(const struct shell *sh, size_t argc, char **argv) {
+    int n = atomic_get(&num_clients);
+
+    shell_print(sh, "Frame clock: %d Hz, tick %u", CONFIG_WS2812_FRAME_RATE,
+                ws2812_frame_count());
+    for (int i = 0; i < n; i++) {
+        shell_print(sh, "  %-10s %u frames, %u missed", clients[i]->name,
+                    clients[i]->frames, clients[i]->missed);
+    }
+    return 0;
+}
+
+SHELL_SUBCMD_ADD((ws2812), frame, NULL, "Frame clock clients and missed deadlines",
+                 cmd_frame, 1, 0);
+#endif
+
+#endif /* CONFIG_WS2812_FRAME_CLOCK */
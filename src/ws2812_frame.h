@@ -0,0 +1,31 @@
+#ifndef WS2812_FRAME_H
+#define WS2812_FRAME_H
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+
+// A thread that runs once per frame tick. Register it once, then call
+// ws2812_frame_wait() at the top of its loop instead of sleeping.
+struct ws2812_frame_client {
+    const char *name;
+    struct k_sem tick;      // Given by the frame timer
+    uint32_t frame;         // Tick the client is currently working on
+    uint32_t frames;        // Ticks served
+    uint32_t missed;        // Ticks that passed before the client was ready
+};
+
+// Start the frame clock at CONFIG_WS2812_FRAME_RATE Hz
+void ws2812_frame_start(void);
+
+// Add a client (up to CONFIG_WS2812_FRAME_MAX_CLIENTS)
+int ws2812_frame_register(struct ws2812_frame_client *client, const char *name);
+
+// Block until the next tick and return its number. A client that is still
+// busy when one or more ticks pass has them counted in client->missed and
+// returns at once with the latest tick, so it never falls further behind.
+uint32_t ws2812_frame_wait(struct ws2812_frame_client *client);
+
+// Number of ticks since ws2812_frame_start()
+uint32_t ws2812_frame_count(void);
+
+#endif /* WS2812_FRAME_H */
@@ -0,0 +1,148 @@
+/*
+ * Pixel kernels
+ *
+ * rgb_t buffers are plain byte arrays, so every kernel treats a run of
+ * pixels as 3 * n channel bytes and works on 32-bit words of four lanes,
+ * finishing the last 0-3 bytes one at a time. Words are moved with
+ * memcpy(), which compiles to single loads and stores on cores with
+ * unaligned access and stays correct on the others.
+ *
+ * Multiplies split a word into its even and odd bytes: each 16-bit lane
+ * then holds one channel times a factor of at most 256, so a single
+ * 32-bit multiply scales two channels without carries between them.
+ */
+
+#include "ws2812_kernels.h"
+#include <string.h>
+
+#if defined(__ARM_FEATURE_SIMD32) && __ARM_FEATURE_SIMD32
+#include <arm_acle.h>
+#define HAVE_SIMD32 1
+#endif
+
+#define LANES_LO7 0x7F7F7F7Fu
+#define LANES_MSB 0x80808080u
+#define LANES_EVEN 0x00FF00FFu
+
+static inline uint32_t load32(const uint8_t *p) {
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void store32(uint8_t *p, uint32_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+// Per byte: a + b, saturating at 255
+static inline uint32_t add_sat4(uint32_t a, uint32_t b) {
+#ifdef HAVE_SIMD32
+    return __uqadd8(a, b);
+#else
+    // Add the low 7 bits, then fold in bit 7 and catch each lane's carry out
+    uint32_t sum = (a & LANES_LO7) + (b & LANES_LO7);
+    uint32_t carry = ((a & b) | ((a | b) & sum)) & LANES_MSB;
+
+    sum ^= (a ^ b) & LANES_MSB;
+    return sum | ((carry >> 7) * 0xFF);
+#endif
+}
+
+// Per byte: v * scale / 256
+static inline uint32_t scale4(uint32_t v, uint32_t scale) {
+    uint32_t even = ((v & LANES_EVEN) * scale) >> 8;
+    uint32_t odd = ((v >> 8) & LANES_EVEN) * scale;
+
+    return (even & LANES_EVEN) | (odd & ~LANES_EVEN);
+}
+
+// Per byte: (s * a + d * (256 - a)) / 256, a = 0..256
+static inline uint32_t lerp4(uint32_t d, uint32_t s, uint32_t a) {
+    uint32_t even = ((s & LANES_EVEN) * a + (d & LANES_EVEN) * (256 - a)) >> 8;
+    uint32_t odd = ((s >> 8) & LANES_EVEN) * a + ((d >> 8) & LANES_EVEN) * (256 - a);
+
+    return (even & LANES_EVEN) | (odd & ~LANES_EVEN);
+}
+
+void ws2812_kernel_fade(rgb_t *buf, size_t n, uint8_t scale) {
+    uint8_t *p = (uint8_t *)buf;
+    size_t len = n * sizeof(rgb_t);
+    size_t i = 0;
+
+    for (; i + 4 <= len; i += 4) {
+        store32(p + i, scale4(load32(p + i), scale));
+    }
+    for (; i < len; i++) {
+        p[i] = (p[i] * scale) >> 8;
+    }
+}
+
+void ws2812_kernel_add(rgb_t *dst, const rgb_t *src, size_t n) {
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+    size_t len = n * sizeof(rgb_t);
+    size_t i = 0;
+
+    for (; i + 4 <= len; i += 4) {
+        store32(d + i, add_sat4(load32(d + i), load32(s + i)));
+    }
+    for (; i < len; i++) {
+        unsigned int sum = d[i] + s[i];
+        d[i] = sum > 255 ? 255 : sum;
+    }
+}
+
+void ws2812_kernel_blend(rgb_t *dst, const rgb_t *src, size_t n, uint8_t alpha) {
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+    size_t len = n * sizeof(rgb_t);
+    size_t i = 0;
+
+    // Map alpha 0..255 onto 0..256 so both ends and the midpoint are exact
+    uint32_t a = alpha + (alpha > 128);
+
+    if (a == 0) {
+        return;
+    }
+    if (a == 256) {
+        memmove(d, s, len);
+        return;
+    }
+#ifdef HAVE_SIMD32
+    if (a == 128) {
+        // Halving add: an exact 50% mix in one instruction per word
+        for (; i + 4 <= len; i += 4) {
+            store32(d + i, __uhadd8(load32(d + i), load32(s + i)));
+        }
+    }
+#endif
+    for (; i + 4 <= len; i += 4) {
+        store32(d + i, lerp4(load32(d + i), load32(s + i), a));
+    }
+    for (; i < len; i++) {
+        d[i] = (s[i] * a + d[i] * (256 - a)) >> 8;
+    }
+}
+
+void ws2812_kernel_fill(rgb_t *dst, size_t n, rgb_t color) {
+    uint8_t *d = (uint8_t *)dst;
+    size_t len = n * sizeof(rgb_t);
+    size_t i = 0;
+
+    // Four pixels make three whole words
+    uint8_t pattern[12];
+    for (int k = 0; k < 4; k++) {
+        memcpy(&pattern[k * sizeof(rgb_t)], &color, sizeof(rgb_t));
+    }
+    uint32_t w0 = load32(&pattern[0]), w1 = load32(&pattern[4]), w2 = load32(&pattern[8]);
+
+    for (; i + 12 <= len; i += 12) {
+        store32(d + i, w0);
+        store32(d + i + 4, w1);
+        store32(d + i + 8, w2);
+    }
+    for (; i < len; i++) {
+        d[i] = pattern[i % 12];
+    }
+}
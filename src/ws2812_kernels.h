@@ -0,0 +1,24 @@
+#ifndef WS2812_KERNELS_H
+#define WS2812_KERNELS_H
+
+#include "ws2812.h"
+
+// Pixel kernels over runs of n rgb_t, four channel bytes at a time.
+// Cores with the ARM SIMD32 extension (Cortex-M4/M7/M33) use UQADD8 and
+// UHADD8; everything else runs the portable SWAR versions, which give
+// identical results. Buffers need no particular alignment.
+
+// Every channel times scale/256 (as scale8())
+void ws2812_kernel_fade(rgb_t *buf, size_t n, uint8_t scale);
+
+// dst += src per channel, saturating at 255
+void ws2812_kernel_add(rgb_t *dst, const rgb_t *src, size_t n);
+
+// dst = dst + (src - dst) * alpha/255 per channel; 0 keeps dst, 255 copies src,
+// 128 gives (dst + src) / 2
+void ws2812_kernel_blend(rgb_t *dst, const rgb_t *src, size_t n, uint8_t alpha);
+
+// Set n pixels to color
+void ws2812_kernel_fill(rgb_t *dst, size_t n, rgb_t color);
+
+#endif /* WS2812_KERNELS_H */
@@ -0,0 +1,195 @@
+/*
+ * Layer compositor
+ *
+ * Each producer owns a layer and never touches matrix_mutex: it draws into
+ * its private buffer and commits, which only copies the buffer under the
+ * layer's own spinlock. The display thread composes changed layers into the
+ * framebuffer right before encoding.
+ */
+
+#include "ws2812_layer.h"
+#include "ws2812_kernels.h"
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(ws2812_layer, LOG_LEVEL_INF);
+
+#ifdef CONFIG_WS2812_LAYERS
+
+// Registered layers, kept sorted by ascending z, and whether composing is
+// held off. Guarded by matrix_mutex, which the compositor runs under.
+static struct ws2812_layer *layers[CONFIG_WS2812_MAX_LAYERS];
+static int num_layers;
+static bool held;
+
+// Composition scratch area for one viewport, and which of its pixels the
+// layers draw
+static rgb_t scratch[MATRIX_WIDTH * MATRIX_HEIGHT];
+static bool cover[MATRIX_WIDTH * MATRIX_HEIGHT];
+
+// Matrix pixels the last compose wrote, one bit each, row by row
+static uint32_t composed[DIV_ROUND_UP(MATRIX_WIDTH * MATRIX_HEIGHT, 32)];
+
+int ws2812_layer_register(struct ws2812_layer *layer) {
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+
+    if (num_layers == ARRAY_SIZE(layers)) {
+        k_mutex_unlock(&matrix_mutex);
+        LOG_ERR("No room for another layer (CONFIG_WS2812_MAX_LAYERS=%d)",
+                CONFIG_WS2812_MAX_LAYERS);
+        return -ENOMEM;
+    }
+
+    int i = num_layers++;
+    while (i > 0 && layers[i - 1]->z > layer->z) {
+        layers[i] = layers[i - 1];
+        i--;
+    }
+    layers[i] = layer;
+    layer->changed = true;
+
+    k_mutex_unlock(&matrix_mutex);
+    return 0;
+}
+
+void ws2812_layer_fill(struct ws2812_layer *layer, rgb_t color) {
+    ws2812_kernel_fill(layer->draw, layer->w * layer->h, color);
+}
+
+void ws2812_layer_commit(struct ws2812_layer *layer) {
+    k_spinlock_key_t key = k_spin_lock(&layer->lock);
+
+    memcpy(layer->shown, layer->draw, layer->w * layer->h * sizeof(rgb_t));
+    layer->changed = true;
+
+    k_spin_unlock(&layer->lock, key);
+}
+
+void ws2812_layer_set_alpha(struct ws2812_layer *layer, uint8_t alpha) {
+    k_spinlock_key_t key = k_spin_lock(&layer->lock);
+
+    layer->alpha = alpha;
+    layer->changed = true;
+
+    k_spin_unlock(&layer->lock, key);
+}
+
+// Blend the part of layer inside rect (x, y, w, h) into scratch (stride w)
+// and mark the pixels it draws in cover[]. Black keyed or added pixels draw
+// nothing, so whatever is below them shows through.
+static void blend_layer(struct ws2812_layer *layer, int x, int y, int w, int h) {
+    int x0 = MAX(x, layer->x), x1 = MIN(x + w, layer->x + layer->w);
+    int y0 = MAX(y, layer->y), y1 = MIN(y + h, layer->y + layer->h);
+
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&layer->lock);
+
+    // Each clipped row is one contiguous run in both buffers
+    for (int py = y0; py < y1; py++) {
+        const rgb_t *src = &layer->shown[(py - layer->y) * layer->w + (x0 - layer->x)];
+        rgb_t *dst = &scratch[(py - y) * w + (x0 - x)];
+        bool *covered = &cover[(py - y) * w + (x0 - x)];
+        int n = x1 - x0;
+
+        switch (layer->blend) {
+        case WS2812_BLEND_OPAQUE:
+            memcpy(dst, src, n * sizeof(rgb_t));
+            memset(covered, true, n);
+            break;
+        case WS2812_BLEND_KEYED:
+            for (int i = 0; i < n; i++) {
+                if (src[i].g | src[i].r | src[i].b) {
+                    dst[i] = src[i];
+                    covered[i] = true;
+                }
+            }
+            break;
+        case WS2812_BLEND_ALPHA:
+            if (layer->alpha != 0) {
+                ws2812_kernel_blend(dst, src, n, layer->alpha);
+                memset(covered, true, n);
+            }
+            break;
+        case WS2812_BLEND_ADD:
+            ws2812_kernel_add(dst, src, n);
+            for (int i = 0; i < n; i++) {
+                covered[i] |= (src[i].g | src[i].r | src[i].b) != 0;
+            }
+            break;
+        }
+    }
+
+    k_spin_unlock(&layer->lock, key);
+}
+
+// Recompose one rectangle of the matrix from every layer overlapping it.
+// Only pixels some layer draws are written, plus those a layer drew last
+// time and no longer does, which go black; the rest keep what was drawn
+// into the framebuffer directly.
+static void compose_rect(int x, int y, int w, int h) {
+    memset(scratch, 0, w * h * sizeof(rgb_t));
+    memset(cover, false, w * h);
+
+    for (int i = 0; i < num_layers; i++) {
+        blend_layer(layers[i], x, y, w, h);
+    }
+
+    for (int py = 0; py < h; py++) {
+        int run = 0;
+
+        for (int px = 0; px <= w; px++) {
+            bool write = false;
+
+            if (px < w) {
+                int bit = (y + py) * MATRIX_WIDTH + x + px;
+
+                write = cover[py * w + px] || (composed[bit >> 5] & BIT(bit & 31));
+                WRITE_BIT(composed[bit >> 5], bit & 31, cover[py * w + px]);
+            }
+            if (write) {
+                run++;
+            } else if (run > 0) {
+                ws2812_write_row(x + px - run, y + py, &scratch[py * w + px - run], run);
+                run = 0;
+            }
+        }
+    }
+}
+
+void ws2812_layers_hold(bool hold) {
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+    held = hold;
+    if (!hold) {
+        for (int i = 0; i < num_layers; i++) {
+            layers[i]->changed = true;
+        }
+    }
+    k_mutex_unlock(&matrix_mutex);
+}
+
+void ws2812_layers_compose(void) {
+    if (held) {
+        return;
+    }
+
+    for (int i = 0; i < num_layers; i++) {
+        struct ws2812_layer *layer = layers[i];
+
+        if (!layer->changed) {
+            continue;
+        }
+        layer->changed = false;
+
+        // Clip to the matrix so scratch is always large enough
+        int x = MAX(layer->x, 0), y = MAX(layer->y, 0);
+        int w = MIN(layer->x + layer->w, MATRIX_WIDTH) - x;
+        int h = MIN(layer->y + layer->h, MATRIX_HEIGHT) - y;
+        if (w > 0 && h > 0) {
+            compose_rect(x, y, w, h);
+        }
+    }
+}
+
+#endif /* CONFIG_WS2812_LAYERS */
@@ -0,0 +1,76 @@
+#ifndef WS2812_LAYER_H
+#define WS2812_LAYER_H
+
+#include "ws2812.h"
+
+// How a layer combines with what is below it
+enum ws2812_blend {
+    WS2812_BLEND_OPAQUE,  // Replace
+    WS2812_BLEND_KEYED,   // Replace, but black pixels are transparent
+    WS2812_BLEND_ALPHA,   // Mix by the layer alpha (255 = opaque)
+    WS2812_BLEND_ADD,     // Saturating add
+};
+
+// A producer-owned drawing surface clipped to a viewport of the matrix.
+// The owner draws into draw[] without any lock and publishes it with
+// ws2812_layer_commit(); the compositor only ever reads shown[].
+struct ws2812_layer {
+    int16_t x, y;       // Viewport top-left on the matrix
+    uint8_t w, h;       // Viewport size
+    int8_t z;           // Higher z is drawn on top
+    uint8_t blend;      // enum ws2812_blend
+    uint8_t alpha;      // Used by WS2812_BLEND_ALPHA
+    bool changed;       // Committed since the last compose
+    rgb_t *draw;        // w * h, owned by the producer
+    rgb_t *shown;       // w * h, last committed frame
+    struct k_spinlock lock;  // Guards shown[] and changed
+};
+
+// Define a layer with static pixel storage
+#define WS2812_LAYER_DEFINE(_name, _x, _y, _w, _h, _z, _blend)          \
+    static rgb_t _name##_pixels[2][(_w) * (_h)];                         \
+    struct ws2812_layer _name = {                                       \
+        .x = (_x), .y = (_y), .w = (_w), .h = (_h), .z = (_z),          \
+        .blend = (_blend), .alpha = 255,                                \
+        .draw = _name##_pixels[0], .shown = _name##_pixels[1],          \
+    }
+
+// Add a layer to the compositor (up to CONFIG_WS2812_MAX_LAYERS)
+int ws2812_layer_register(struct ws2812_layer *layer);
+
+// Drawing into the layer's private buffer, in viewport coordinates
+static inline void ws2812_layer_set_pixel(struct ws2812_layer *layer, int x, int y, rgb_t color) {
+    if (x >= 0 && x < layer->w && y >= 0 && y < layer->h) {
+        layer->draw[y * layer->w + x] = color;
+    }
+}
+
+static inline rgb_t ws2812_layer_get_pixel(const struct ws2812_layer *layer, int x, int y) {
+    if (x >= 0 && x < layer->w && y >= 0 && y < layer->h) {
+        return layer->draw[y * layer->w + x];
+    }
+    return (rgb_t){0, 0, 0};
+}
+
+void ws2812_layer_fill(struct ws2812_layer *layer, rgb_t color);
+
+// Publish the draw buffer; the compositor picks it up on the next frame
+void ws2812_layer_commit(struct ws2812_layer *layer);
+
+// Change the layer alpha (WS2812_BLEND_ALPHA)
+void ws2812_layer_set_alpha(struct ws2812_layer *layer, uint8_t alpha);
+
+// Hold off composing while another effect owns the whole matrix (a clip).
+// Layers can still be drawn and committed; on release every layer is
+// recomposed on the next frame.
+void ws2812_layers_hold(bool hold);
+
+// Merge changed layers into the framebuffer. Called by ws2812_update(),
+// so it runs with matrix_mutex held. Only the viewports of layers that
+// changed are recomposed, and only pixels a layer draws are written:
+// pixels outside every layer, or under black keyed or added pixels, keep
+// what was drawn into the framebuffer with ws2812_set_pixel() and friends.
+// A pixel a layer stops drawing goes black.
+void ws2812_layers_compose(void);
+
+#endif /* WS2812_LAYER_H */
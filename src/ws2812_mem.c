@@ -0,0 +1,158 @@
+/*
+ * RAM and stack report
+ *
+ * "ws2812 mem" shows where the RAM goes and what would be enough:
+ *
+ *  - the peak stack use of every thread since boot, from the untouched
+ *    part of its stack (INIT_STACKS fills stacks with a pattern at creation)
+ *  - the driver's static buffers against what the chosen encoding fills
+ *  - the system heap's peak allocation (SYS_HEAP_RUNTIME_STATS)
+ *
+ * and ends with the Kconfig values that fit the run: each stack's peak plus
+ * CONFIG_WS2812_MEM_MARGIN percent, per Kconfig symbol that sizes it. Peaks
+ * only cover what has run, so exercise every effect and command first.
+ */
+
+#include "ws2812.h"
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/sys_heap.h>
+
+#ifdef CONFIG_WS2812_MEM
+
+#define MARGIN CONFIG_WS2812_MEM_MARGIN
+
+#if defined(CONFIG_SYS_HEAP_RUNTIME_STATS) && CONFIG_HEAP_MEM_POOL_SIZE > 0
+#define MEM_HEAP_STATS
+extern struct k_heap _system_heap;
+#endif
+
+// Kconfig symbol sizing the stack of the threads whose name starts with
+// prefix
+static const struct {
+    const char *prefix;
+    const char *symbol;
+} stack_symbols[] = {
+    { "quad", "CONFIG_SAMPLE_QUAD_STACK_SIZE" },
+    { "display", "CONFIG_SAMPLE_DISPLAY_STACK_SIZE" },
+    { "anim_", "CONFIG_WS2812_ANIM_STACK_SIZE" },
+    { "ws2812_rx", "CONFIG_WS2812_RX_POLL_STACK_SIZE" },
+    { "main", "CONFIG_MAIN_STACK_SIZE" },
+    { "sysworkq", "CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE" },
+    { "logging", "CONFIG_LOG_PROCESS_THREAD_STACK_SIZE" },
+    { "shell", "CONFIG_SHELL_STACK_SIZE" },
+    { "idle", "CONFIG_IDLE_STACK_SIZE" },
+};
+
+// Worst thread per symbol, gathered by one report
+struct stack_peak {
+    size_t size;
+    size_t used;
+};
+
+struct mem_report {
+    const struct shell *sh;
+    struct stack_peak peaks[ARRAY_SIZE(stack_symbols)];
+    size_t stack_total;
+};
+
+// Add the margin and round up to align
+static size_t with_margin(size_t bytes, size_t align) {
+    return ROUND_UP(bytes * (100 + MARGIN) / 100, align);
+}
+
+static void report_thread(const struct k_thread *thread, void *user_data) {
+    struct mem_report *r = user_data;
+    const char *name = k_thread_name_get((k_tid_t)thread);
+    size_t size = thread->stack_info.size;
+    size_t unused = 0;
+    int sym = -1;
+
+    if (k_thread_stack_space_get(thread, &unused) != 0) {
+        unused = 0;
+    }
+    size_t used = size - unused;
+
+    if (name == NULL || name[0] == '\0') {
+        name = "(unnamed)";
+    }
+    for (int i = 0; i < ARRAY_SIZE(stack_symbols); i++) {
+        if (strncmp(name, stack_symbols[i].prefix, strlen(stack_symbols[i].prefix)) == 0) {
+            sym = i;
+            break;
+        }
+    }
+
+    shell_print(r->sh, "  %-20s %6u / %-6u %3u%%%s", name, (unsigned int)used,
+                (unsigned int)size, size ? (unsigned int)(used * 100 / size) : 0,
+                sym < 0 ? "  (no Kconfig symbol)" : "");
+    r->stack_total += size;
+    if (sym >= 0) {
+        r->peaks[sym].size = MAX(r->peaks[sym].size, size);
+        r->peaks[sym].used = MAX(r->peaks[sym].used, used);
+    }
+}
+
+static int cmd_mem(const struct shell *sh, size_t argc, char **argv) {
+    static struct mem_report r;
+    struct ws2812_ram_info ram;
+
+    memset(&r, 0, sizeof(r));
+    r.sh = sh;
+
+    shell_print(sh, "Stacks (peak used / size, bytes):");
+    // Unlocked: printing may block
+    k_thread_foreach_unlocked(report_thread, &r);
+    shell_print(sh, "  %-20s %15u", "total", (unsigned int)r.stack_total);
+
+    ws2812_get_ram_info(&ram);
+    shell_print(sh, "Driver static RAM (bytes):");
+    shell_print(sh, "  %-20s %6u", "framebuffer", (unsigned int)ram.framebuffer);
+    shell_print(sh, "  %-20s %6u", "tables", (unsigned int)ram.tables);
+    if (ram.spi_bufs) {
+        shell_print(sh, "  %-20s %6u, %u filled by the %u-bit encoding", "SPI buffers",
+                    (unsigned int)ram.spi_bufs, (unsigned int)ram.spi_bufs_used,
+                    ram.symbol_bits);
+    }
+
+#ifdef MEM_HEAP_STATS
+    struct sys_memory_stats heap;
+
+    sys_heap_runtime_stats_get(&_system_heap.heap, &heap);
+    shell_print(sh, "Heap: %u of %u bytes allocated, peak %u", (unsigned int)heap.allocated_bytes,
+                CONFIG_HEAP_MEM_POOL_SIZE, (unsigned int)heap.max_allocated_bytes);
+#elif CONFIG_HEAP_MEM_POOL_SIZE > 0
+    shell_print(sh, "Heap: %u bytes (enable CONFIG_SYS_HEAP_RUNTIME_STATS for its peak)",
+                CONFIG_HEAP_MEM_POOL_SIZE);
+#endif
+
+    shell_print(sh, "Recommended for this run (peak + %d%%):", MARGIN);
+    for (int i = 0; i < ARRAY_SIZE(stack_symbols); i++) {
+        const struct stack_peak *p = &r.peaks[i];
+        size_t want = with_margin(p->used, 64);
+
+        if (p->size == 0) {
+            continue;
+        }
+        shell_print(sh, "  %s=%u  # now %u", stack_symbols[i].symbol, (unsigned int)want,
+                    (unsigned int)p->size);
+    }
+    if (ram.symbol_bits && ram.spi_bufs_used < ram.spi_bufs) {
+        // Only while the SPI clock, and so the encoding, stays the same
+        shell_print(sh, "  CONFIG_WS2812_MAX_SYMBOL_BITS=%u  # saves %u bytes at this SPI clock",
+                    ram.symbol_bits, (unsigned int)(ram.spi_bufs - ram.spi_bufs_used));
+    }
+#ifdef MEM_HEAP_STATS
+    shell_print(sh, "  CONFIG_HEAP_MEM_POOL_SIZE=%u  # now %u%s",
+                (unsigned int)with_margin(heap.max_allocated_bytes, 256),
+                CONFIG_HEAP_MEM_POOL_SIZE,
+                heap.max_allocated_bytes ? "" : ", nothing allocated");
+#endif
+    return 0;
+}
+
+SHELL_SUBCMD_ADD((ws2812), mem, NULL, "Stack, static buffer and heap use, with recommended sizes",
+                 cmd_mem, 1, 0);
+
+#endif /* CONFIG_WS2812_MEM */
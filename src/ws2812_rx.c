@@ -0,0 +1,332 @@
+/*
+ * Frame stream receiver
+ *
+ * Parses Adalight frames off a UART one byte at a time and stores each
+ * pixel byte straight into the frame being received, with no staging
+ * buffer. Frames are triple buffered: the receiver always has a free frame
+ * to fill, a complete frame waits in "ready" until the display side swaps
+ * it out, and a ready frame the display never got to is replaced by the
+ * newer one and counted as dropped. The display side runs as a work item:
+ * it copies the frame into the framebuffer and calls ws2812_update().
+ *
+ * With CONFIG_UART_INTERRUPT_DRIVEN bytes are parsed in the UART ISR;
+ * otherwise (e.g. the native_sim pty) a thread polls the UART.
+ */
+
+#include "ws2812_rx.h"
+#include "ws2812.h"
+#include <string.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/crc.h>
+
+LOG_MODULE_REGISTER(ws2812_rx, LOG_LEVEL_INF);
+
+#ifdef CONFIG_WS2812_RX
+
+#define RX_PAYLOAD (NUM_LEDS * 3)
+
+static const struct device *const rx_dev = DEVICE_DT_GET(DT_CHOSEN(ws2812_rx_uart));
+
+// Triple buffer. fill belongs to the receiver and show to the display
+// work; ready is swapped between them, with READY_FRESH set while it holds
+// a frame that has not been shown.
+#define READY_FRESH BIT(2)
+#define READY_INDEX(v) ((v) & 3)
+
+static rgb_t frames[3][NUM_LEDS];
+static uint32_t frame_start[3];     // Cycle count at each frame's first header byte
+static uint8_t fill;
+static uint8_t show = 2;
+static atomic_t ready = ATOMIC_INIT(1);
+
+// Where each wire byte of a pixel (R, G, B) goes in rgb_t
+static const uint8_t channel_offset[3] = {
+    offsetof(rgb_t, r), offsetof(rgb_t, g), offsetof(rgb_t, b),
+};
+
+static const uint8_t magic[3] = { 'A', 'd', 'a' };
+
+enum rx_state {
+    RX_MAGIC,
+    RX_COUNT_HI,
+    RX_COUNT_LO,
+    RX_CHECK,
+    RX_PAYLOAD_BYTES,
+    RX_CRC,
+    RX_SKIP,
+};
+
+// Parser state, only touched by the receiving context
+static struct {
+    uint8_t state;
+    uint8_t magic_pos;
+    uint8_t hi, lo;
+    uint8_t channel;
+    uint8_t crc;
+    uint32_t left;      // Payload bytes still to come, or bytes to skip
+    uint8_t *pixel;     // Pixel being received in frames[fill]
+} rx;
+
+static struct {
+    uint32_t frames;
+    uint32_t dropped;
+    uint32_t bad_header;
+    uint32_t bad_crc;
+    uint32_t sync_bytes;
+    k_ticks_t first_shown;  // Uptime ticks: 64 bits, so long runs do not wrap
+    k_ticks_t last_shown;
+    uint32_t latency_min;   // Cycle counts
+    uint32_t latency_max;
+    uint64_t latency_total;
+} stats;
+
+// Updated from the ISR and the display work
+static struct k_spinlock stats_lock;
+
+static void rx_show(struct k_work *work);
+static K_WORK_DEFINE(show_work, rx_show);
+
+#define COUNT(field)                                            \
+    do {                                                        \
+        k_spinlock_key_t key = k_spin_lock(&stats_lock);        \
+        stats.field++;                                          \
+        k_spin_unlock(&stats_lock, key);                        \
+    } while (0)
+
+// A whole frame is in frames[fill]: publish it and take the free frame
+static void rx_frame_done(void) {
+    atomic_val_t old = atomic_set(&ready, fill | READY_FRESH);
+
+    if (old & READY_FRESH) {
+        COUNT(dropped);
+    }
+    fill = READY_INDEX(old);
+    k_work_submit(&show_work);
+}
+
+static void rx_byte(uint8_t c) {
+    switch (rx.state) {
+    case RX_MAGIC:
+        if (c == magic[rx.magic_pos]) {
+            if (rx.magic_pos == 0) {
+                frame_start[fill] = k_cycle_get_32();
+            }
+            if (++rx.magic_pos == sizeof(magic)) {
+                rx.magic_pos = 0;
+                rx.state = RX_COUNT_HI;
+            }
+        } else {
+            // The byte may start the next header
+            rx.magic_pos = c == magic[0];
+            if (rx.magic_pos) {
+                frame_start[fill] = k_cycle_get_32();
+            }
+            COUNT(sync_bytes);
+        }
+        break;
+
+    case RX_COUNT_HI:
+        rx.hi = c;
+        rx.state = RX_COUNT_LO;
+        break;
+
+    case RX_COUNT_LO:
+        rx.lo = c;
+        rx.state = RX_CHECK;
+        break;
+
+    case RX_CHECK: {
+        uint32_t count = ((rx.hi << 8) | rx.lo) + 1;
+
+        if (c != (rx.hi ^ rx.lo ^ 0x55)) {
+            COUNT(bad_header);
+            rx.state = RX_MAGIC;
+        } else if (count != NUM_LEDS) {
+            // A real header for another panel size: skip its payload
+            COUNT(bad_header);
+            rx.left = count * 3 + IS_ENABLED(CONFIG_WS2812_RX_CRC);
+            rx.state = RX_SKIP;
+        } else {
+            rx.left = RX_PAYLOAD;
+            rx.channel = 0;
+            rx.crc = 0xff;
+            rx.pixel = (uint8_t *)frames[fill];
+            rx.state = RX_PAYLOAD_BYTES;
+        }
+        break;
+    }
+
+    case RX_PAYLOAD_BYTES:
+        rx.pixel[channel_offset[rx.channel]] = c;
+        if (++rx.channel == 3) {
+            rx.channel = 0;
+            rx.pixel += sizeof(rgb_t);
+        }
+#ifdef CONFIG_WS2812_RX_CRC
+        rx.crc = crc8_ccitt(rx.crc, &c, 1);
+#endif
+        if (--rx.left == 0) {
+            if (IS_ENABLED(CONFIG_WS2812_RX_CRC)) {
+                rx.state = RX_CRC;
+            } else {
+                rx.state = RX_MAGIC;
+                rx_frame_done();
+            }
+        }
+        break;
+
+    case RX_CRC:
+        if (c == rx.crc) {
+            rx_frame_done();
+        } else {
+            COUNT(bad_crc);
+        }
+        rx.state = RX_MAGIC;
+        break;
+
+    case RX_SKIP:
+        if (--rx.left == 0) {
+            rx.state = RX_MAGIC;
+        }
+        break;
+    }
+}
+
+static void rx_show(struct k_work *work) {
+    if (!(atomic_get(&ready) & READY_FRESH)) {
+        return;
+    }
+    show = READY_INDEX(atomic_set(&ready, show));
+
+    k_mutex_lock(&matrix_mutex, K_FOREVER);
+    ws2812_blit(0, 0, MATRIX_WIDTH, MATRIX_HEIGHT, frames[show]);
+    ws2812_update();
+    k_mutex_unlock(&matrix_mutex);
+
+    uint32_t latency = k_cycle_get_32() - frame_start[show];
+    k_ticks_t now = k_uptime_ticks();
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    if (stats.frames == 0) {
+        stats.first_shown = now;
+        stats.latency_min = latency;
+    }
+    stats.frames++;
+    stats.last_shown = now;
+    stats.latency_min = MIN(stats.latency_min, latency);
+    stats.latency_max = MAX(stats.latency_max, latency);
+    stats.latency_total += latency;
+    k_spin_unlock(&stats_lock, key);
+}
+
+#ifdef CONFIG_UART_INTERRUPT_DRIVEN
+static void rx_isr(const struct device *dev, void *user_data) {
+    uint8_t c;
+
+    while (uart_irq_update(dev) && uart_irq_rx_ready(dev)) {
+        while (uart_fifo_read(dev, &c, 1) == 1) {
+            rx_byte(c);
+        }
+    }
+}
+#else
+K_THREAD_STACK_DEFINE(rx_stack, CONFIG_WS2812_RX_POLL_STACK_SIZE);
+static struct k_thread rx_thread;
+
+// Drain whatever has arrived, then give the CPU back for a tick
+static void rx_poll_entry(void *p1, void *p2, void *p3) {
+    unsigned char c;
+
+    for (;;) {
+        while (uart_poll_in(rx_dev, &c) == 0) {
+            rx_byte(c);
+        }
+        k_sleep(K_TICKS(1));
+    }
+}
+#endif
+
+int ws2812_rx_start(void) {
+    if (!device_is_ready(rx_dev)) {
+        LOG_ERR("Frame receiver UART %s not ready", rx_dev->name);
+        return -ENODEV;
+    }
+
+#ifdef CONFIG_UART_INTERRUPT_DRIVEN
+    int ret = uart_irq_callback_user_data_set(rx_dev, rx_isr, NULL);
+
+    if (ret < 0) {
+        LOG_ERR("Cannot set the %s callback: %d", rx_dev->name, ret);
+        return ret;
+    }
+    uart_irq_rx_enable(rx_dev);
+#else
+    k_thread_create(&rx_thread, rx_stack, K_THREAD_STACK_SIZEOF(rx_stack), rx_poll_entry, NULL,
+                    NULL, NULL, CONFIG_WS2812_RX_POLL_PRIO, 0, K_NO_WAIT);
+    k_thread_name_set(&rx_thread, "ws2812_rx");
+#endif
+
+    LOG_INF("Receiving %d-LED frames on %s%s", NUM_LEDS, rx_dev->name,
+            IS_ENABLED(CONFIG_WS2812_RX_CRC) ? " (with CRC-8)" : "");
+    return 0;
+}
+
+void ws2812_rx_get_stats(struct ws2812_rx_stats *st) {
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    st->frames = stats.frames;
+    st->dropped = stats.dropped;
+    st->bad_header = stats.bad_header;
+    st->bad_crc = stats.bad_crc;
+    st->sync_bytes = stats.sync_bytes;
+    st->span_us = k_ticks_to_us_floor64(stats.last_shown - stats.first_shown);
+    st->latency_min_us = k_cyc_to_us_floor32(stats.latency_min);
+    st->latency_avg_us = stats.frames ? k_cyc_to_us_floor32(stats.latency_total / stats.frames)
+                                      : 0;
+    st->latency_max_us = k_cyc_to_us_floor32(stats.latency_max);
+    k_spin_unlock(&stats_lock, key);
+}
+
+void ws2812_rx_reset_stats(void) {
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    memset(&stats, 0, sizeof(stats));
+    k_spin_unlock(&stats_lock, key);
+}
+
+#ifdef CONFIG_WS2812_SHELL
+static int cmd_rx(const struct shell *sh, size_t argc, char **argv) {
+    struct ws2812_rx_stats st;
+
+    ws2812_rx_get_stats(&st);
+
+    // Sustained rate over the frames shown since the last reset, in centi-FPS
+    uint32_t cfps = (st.frames > 1 && st.span_us) ?
+                    (uint64_t)(st.frames - 1) * 100000000 / st.span_us : 0;
+
+    shell_print(sh, "Frames:  %u shown, %u dropped (overrun)", st.frames, st.dropped);
+    shell_print(sh, "Errors:  %u bad headers, %u bad CRCs, %u bytes skipped", st.bad_header,
+                st.bad_crc, st.sync_bytes);
+    shell_print(sh, "Rate:    %u.%02u FPS", cfps / 100, cfps % 100);
+    shell_print(sh, "Latency: min %u avg %u max %u us (first byte to update)",
+                st.latency_min_us, st.latency_avg_us, st.latency_max_us);
+    return 0;
+}
+
+static int cmd_rx_reset(const struct shell *sh, size_t argc, char **argv) {
+    ws2812_rx_reset_stats();
+    shell_print(sh, "Receiver statistics cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_rx,
+    SHELL_CMD(reset, NULL, "Clear the receiver statistics", cmd_rx_reset),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_SUBCMD_ADD((ws2812), rx, &sub_rx, "Frame receiver statistics [reset]", cmd_rx, 1, 0);
+#endif
+
+#endif /* CONFIG_WS2812_RX */
@@ -0,0 +1,37 @@
+#ifndef WS2812_RX_H
+#define WS2812_RX_H
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+
+// Frames streamed from a host over the UART chosen as "ws2812,rx-uart",
+// Adalight framed:
+//
+//   'A' 'd' 'a' hi lo (hi ^ lo ^ 0x55)  R G B ... (NUM_LEDS pixels)  [crc]
+//
+// where hi:lo is the LED count minus one and pixels run row by row from
+// the top-left corner. With CONFIG_WS2812_RX_CRC a CRC-8 (CCITT, initial
+// 0xff) of the pixel bytes follows, which plain Adalight senders do not
+// send. Each complete frame is shown with one ws2812_update().
+
+struct ws2812_rx_stats {
+    uint32_t frames;        // Shown
+    uint32_t dropped;       // Received, but replaced by a newer one before shown
+    uint32_t bad_header;    // Header check byte or LED count wrong
+    uint32_t bad_crc;
+    uint32_t sync_bytes;    // Bytes skipped looking for a header
+    uint64_t span_us;       // From the first to the last frame shown
+    uint32_t latency_min_us;  // First header byte to ws2812_update() returning
+    uint32_t latency_avg_us;
+    uint32_t latency_max_us;
+};
+
+// Start receiving; the receiver owns the whole matrix from then on
+int ws2812_rx_start(void);
+
+// Counters since the start or the last reset
+void ws2812_rx_get_stats(struct ws2812_rx_stats *st);
+
+void ws2812_rx_reset_stats(void);
+
+#endif /* WS2812_RX_H */
@@ -0,0 +1,70 @@
+/*
+ * "ws2812" shell command root
+ *
+ * Other modules hook their own subcommands in with
+ * SHELL_SUBCMD_ADD((ws2812), ...).
+ */
+
+#include "ws2812.h"
+#include "ws2812_backend.h"
+#include <zephyr/shell/shell.h>
+
+#ifdef CONFIG_WS2812_SHELL
+
+SHELL_SUBCMD_SET_CREATE(ws2812_cmds, (ws2812));
+SHELL_CMD_REGISTER(ws2812, &ws2812_cmds, "WS2812 driver commands", NULL);
+
+static int cmd_backend(const struct shell *sh, size_t argc, char **argv) {
+    shell_print(sh, "Backend:     %s (%s)", ws2812_backend.name,
+                ws2812_backend.async ? "returns before the frame is out" : "blocking");
+    shell_print(sh, "Frame:       %u LEDs, %u ns on the wire", WS2812_CHAIN_LEN,
+                ws2812_backend.frame_ns());
+    return 0;
+}
+
+SHELL_SUBCMD_ADD((ws2812), backend, NULL, "Show the output backend", cmd_backend, 1, 0);
+
+#ifdef CONFIG_WS2812_BACKEND_SPI
+static int cmd_encoding(const struct shell *sh, size_t argc, char **argv) {
+    const struct ws2812_encoding *enc = ws2812_get_encoding();
+    const struct ws2812_timing *lim = &ws2812_default_timing;
+
+    shell_print(sh, "SPI clock:   %u Hz (%u ns/bit)", enc->spi_hz, enc->spi_bit_ns);
+    shell_print(sh, "Symbol:      %u SPI bits per LED bit (%u.%02u LED bits per byte)",
+                enc->symbol_bits, 8 / enc->symbol_bits, (800 / enc->symbol_bits) % 100);
+    shell_print(sh, "  0 bit:     0x%02x, T0H %u ns (limits %u-%u)", enc->zero_symbol,
+                enc->t0h_ns, lim->t0h_min_ns, lim->t0h_max_ns);
+    shell_print(sh, "  1 bit:     0x%02x, T1H %u ns (limits %u-%u)", enc->one_symbol,
+                enc->t1h_ns, lim->t1h_min_ns, lim->t1h_max_ns);
+    shell_print(sh, "  period:    %u ns (limits %u-%u), low >= %u ns", enc->period_ns,
+                lim->period_min_ns, lim->period_max_ns, lim->tl_min_ns);
+    shell_print(sh, "Margin:      %u ns", enc->margin_ns);
+#ifdef CONFIG_WS2812_STREAM
+    struct ws2812_stream_info stream;
+
+    ws2812_stream_get_info(&stream);
+    shell_print(sh, "Stream:      %u chunks of %u LEDs, 2 x %u bytes, %u ns per chunk on the wire",
+                stream.chunks, stream.chunk_leds, (unsigned int)stream.chunk_bytes,
+                stream.chunk_wire_ns);
+    shell_print(sh, "  gaps:      longest %u ns, %u reached the reset time", stream.max_gap_ns,
+                stream.underruns);
+#endif
+#ifdef CONFIG_WS2812_TRUNCATE
+    struct ws2812_truncate_info trunc;
+
+    ws2812_truncate_get_info(&trunc);
+    uint32_t avg = trunc.frames ? trunc.leds_sent / trunc.frames : 0;
+
+    shell_print(sh, "Truncate:    %u frames, avg %u of %u LEDs sent (%u%%)", trunc.frames, avg,
+                WS2812_CHAIN_LEN, avg * 100 / WS2812_CHAIN_LEN);
+    shell_print(sh, "  full:      %u frames, refresh every %u ms", trunc.full_frames,
+                trunc.refresh_ms);
+#endif
+    return 0;
+}
+
+SHELL_SUBCMD_ADD((ws2812), encoding, NULL, "Show SPI encoding and timing margins",
+                 cmd_encoding, 1, 0);
+#endif
+
+#endif /* CONFIG_WS2812_SHELL */
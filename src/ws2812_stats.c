@@ -0,0 +1,173 @@
+/*
+ * Driver frame statistics
+ *
+ * ws2812_update() brackets its stages with ws2812_stats_lap(); each stage
+ * keeps min/avg/max and a log2 histogram in microseconds. Frame counters
+ * track sent, skipped (nothing changed) and failed transfers.
+ * "ws2812 stats" prints them and "ws2812 stats reset" clears them.
+ */
+
+#include "ws2812_stats.h"
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/math_extras.h>
+
+#ifdef CONFIG_WS2812_STATS
+
+#define NUM_BUCKETS CONFIG_WS2812_STATS_BUCKETS
+
+struct stat_hist {
+    uint32_t count;
+    uint32_t min;            // Cycles
+    uint32_t max;
+    uint64_t total;
+    uint32_t buckets[NUM_BUCKETS];  // [0] < 1 us, [i] < 2^i us, last is open
+};
+
+static struct {
+    struct stat_hist hist[WS2812_STAT_COUNT];
+    uint32_t sent;
+    uint32_t skipped;
+    uint32_t errors;
+    uint32_t last_start;     // Cycles
+    uint64_t span;           // Cycles from the first frame since the reset to the last
+} stats;
+
+// Updated from the async transfer-done callback too
+static struct k_spinlock stats_lock;
+
+static const char *const stat_names[WS2812_STAT_COUNT] = {
+    [WS2812_STAT_ENCODE] = "encode",
+    [WS2812_STAT_TX_WAIT] = "tx wait",
+    [WS2812_STAT_RESET_WAIT] = "reset wait",
+    [WS2812_STAT_TRANSFER] = "transfer",
+    [WS2812_STAT_INTERVAL] = "interval",
+};
+
+static void hist_add(struct stat_hist *h, uint32_t cycles) {
+    uint32_t us = k_cyc_to_us_floor32(cycles);
+    int bucket = us ? 32 - u32_count_leading_zeros(us) : 0;
+
+    if (h->count == 0 || cycles < h->min) {
+        h->min = cycles;
+    }
+    h->max = MAX(h->max, cycles);
+    h->total += cycles;
+    h->count++;
+    h->buckets[MIN(bucket, NUM_BUCKETS - 1)]++;
+}
+
+uint32_t ws2812_stats_lap(enum ws2812_stat stat, uint32_t start) {
+    uint32_t now = k_cycle_get_32();
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    hist_add(&stats.hist[stat], now - start);
+
+    k_spin_unlock(&stats_lock, key);
+    return now;
+}
+
+void ws2812_stats_frame_sent(uint32_t start) {
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    // Summed per interval, so the span outlives the 32-bit cycle counter
+    if (stats.sent != 0) {
+        hist_add(&stats.hist[WS2812_STAT_INTERVAL], start - stats.last_start);
+        stats.span += start - stats.last_start;
+    }
+    stats.last_start = start;
+    stats.sent++;
+
+    k_spin_unlock(&stats_lock, key);
+}
+
+void ws2812_stats_frame_skipped(void) {
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    stats.skipped++;
+    k_spin_unlock(&stats_lock, key);
+}
+
+void ws2812_stats_error(void) {
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    stats.errors++;
+    k_spin_unlock(&stats_lock, key);
+}
+
+void ws2812_stats_reset(void) {
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    memset(&stats, 0, sizeof(stats));
+    k_spin_unlock(&stats_lock, key);
+}
+
+#ifdef CONFIG_WS2812_SHELL
+static void print_hist(const struct shell *sh, const char *name, const struct stat_hist *h) {
+    if (h->count == 0) {
+        shell_print(sh, "%-11s -", name);
+        return;
+    }
+
+    shell_print(sh, "%-11s n=%u min %u avg %u max %u us", name, h->count,
+                k_cyc_to_us_floor32(h->min), k_cyc_to_us_floor32(h->total / h->count),
+                k_cyc_to_us_floor32(h->max));
+
+    // Non-empty buckets as "<limit:count"
+    char line[NUM_BUCKETS * 24] = "";
+    int len = 0;
+
+    for (int i = 0; i < NUM_BUCKETS && len < sizeof(line); i++) {
+        if (h->buckets[i] == 0) {
+            continue;
+        }
+        if (i == NUM_BUCKETS - 1) {
+            len += snprintk(line + len, sizeof(line) - len, " >=%uus:%u", (uint32_t)BIT(i - 1),
+                            h->buckets[i]);
+        } else {
+            len += snprintk(line + len, sizeof(line) - len, " <%uus:%u", (uint32_t)BIT(i),
+                            h->buckets[i]);
+        }
+    }
+    shell_print(sh, "           %s", line);
+}
+
+static int cmd_stats(const struct shell *sh, size_t argc, char **argv) {
+    struct stat_hist hist[WS2812_STAT_COUNT];
+    uint32_t sent, skipped, errors;
+    uint64_t span;
+
+    // Snapshot so the printout is consistent
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    memcpy(hist, stats.hist, sizeof(hist));
+    sent = stats.sent;
+    skipped = stats.skipped;
+    errors = stats.errors;
+    span = stats.span;
+    k_spin_unlock(&stats_lock, key);
+
+    // Achieved rate over the frames sent since the last reset, in centi-FPS
+    uint64_t span_us = k_cyc_to_us_floor64(span);
+    uint32_t cfps = (sent > 1 && span_us) ? (uint64_t)(sent - 1) * 100000000 / span_us : 0;
+
+    shell_print(sh, "Frames: %u sent, %u skipped (unchanged), %u SPI errors", sent, skipped,
+                errors);
+    shell_print(sh, "Rate:   %u.%02u FPS", cfps / 100, cfps % 100);
+    for (int i = 0; i < WS2812_STAT_COUNT; i++) {
+        print_hist(sh, stat_names[i], &hist[i]);
+    }
+    return 0;
+}
+
+static int cmd_stats_reset(const struct shell *sh, size_t argc, char **argv) {
+    ws2812_stats_reset();
+    shell_print(sh, "Statistics cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_stats,
+    SHELL_CMD(reset, NULL, "Clear the statistics", cmd_stats_reset),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_SUBCMD_ADD((ws2812), stats, &sub_stats, "Frame timing statistics [reset]",
+                 cmd_stats, 1, 0);
+#endif
+
+#endif /* CONFIG_WS2812_STATS */
@@ -0,0 +1,49 @@
+#ifndef WS2812_STATS_H
+#define WS2812_STATS_H
+
+#include <zephyr/kernel.h>
+
+// Timed stages of ws2812_update()
+enum ws2812_stat {
+    WS2812_STAT_ENCODE,      // Re-encoding dirty LEDs
+    WS2812_STAT_TX_WAIT,     // Async: waiting for the previous transfer
+    WS2812_STAT_RESET_WAIT,  // Busy-waiting out the reset gap
+    WS2812_STAT_TRANSFER,    // SPI transfer, start to completion
+    WS2812_STAT_INTERVAL,    // Between the starts of consecutive frames
+    WS2812_STAT_COUNT,
+};
+
+#ifdef CONFIG_WS2812_STATS
+
+// Start of a timed stage
+static inline uint32_t ws2812_stats_now(void) {
+    return k_cycle_get_32();
+}
+
+// Record the stage that began at start; returns now, the start of the next
+uint32_t ws2812_stats_lap(enum ws2812_stat stat, uint32_t start);
+
+// A frame started transmitting at start
+void ws2812_stats_frame_sent(uint32_t start);
+
+// ws2812_update() had nothing new to send
+void ws2812_stats_frame_skipped(void);
+
+// An SPI transfer failed
+void ws2812_stats_error(void);
+
+void ws2812_stats_reset(void);
+
+#else
+
+// Compiled out: every hook is an empty inline
+static inline uint32_t ws2812_stats_now(void) { return 0; }
+static inline uint32_t ws2812_stats_lap(enum ws2812_stat stat, uint32_t start) { return 0; }
+static inline void ws2812_stats_frame_sent(uint32_t start) {}
+static inline void ws2812_stats_frame_skipped(void) {}
+static inline void ws2812_stats_error(void) {}
+static inline void ws2812_stats_reset(void) {}
+
+#endif /* CONFIG_WS2812_STATS */
+
+#endif /* WS2812_STATS_H */
@@ -0,0 +1,94 @@
+/*
+ * WS2812 SPI bit-timing synthesizer
+ *
+ * Given the SPI clock the controller really produces, search for the
+ * shortest SPI bit pattern per WS2812 bit that still meets the LED timing.
+ * At 2.4 MHz this gives 3 bits (2.67 LED bits per SPI byte), at 3.2 MHz
+ * 4 bits, instead of a fixed 8 bits per LED bit.
+ */
+
+#include "ws2812_timing.h"
+
+const struct ws2812_timing ws2812_default_timing = {
+    .t0h_min_ns = CONFIG_WS2812_T0H_MIN_NS,
+    .t0h_max_ns = CONFIG_WS2812_T0H_MAX_NS,
+    .t1h_min_ns = CONFIG_WS2812_T1H_MIN_NS,
+    .t1h_max_ns = CONFIG_WS2812_T1H_MAX_NS,
+    .tl_min_ns = CONFIG_WS2812_TL_MIN_NS,
+    .period_min_ns = CONFIG_WS2812_PERIOD_MIN_NS,
+    .period_max_ns = CONFIG_WS2812_PERIOD_MAX_NS,
+};
+
+// Distance (ps) of value inside [lo, hi], negative when outside
+static int32_t window_margin(uint32_t value, uint32_t lo, uint32_t hi) {
+    int32_t below = (int32_t)value - (int32_t)lo;
+    int32_t above = (int32_t)hi - (int32_t)value;
+    return MIN(below, above);
+}
+
+int ws2812_encoding_synthesize(uint32_t spi_hz, uint8_t max_symbol_bits,
+                               const struct ws2812_timing *limits,
+                               struct ws2812_encoding *enc) {
+    // Far below any usable WS2812 rate; also keeps the ps math in range
+    if (spi_hz < 100000U) {
+        return -EINVAL;
+    }
+
+    // Work in picoseconds so sub-ns SPI bit times don't round away
+    const uint32_t bit_ps = (uint32_t)(1000000000000ULL / spi_hz);
+    const uint32_t t0h_min = limits->t0h_min_ns * 1000U;
+    const uint32_t t0h_max = limits->t0h_max_ns * 1000U;
+    const uint32_t t1h_min = limits->t1h_min_ns * 1000U;
+    const uint32_t t1h_max = limits->t1h_max_ns * 1000U;
+    const uint32_t tl_min = limits->tl_min_ns * 1000U;
+    const uint32_t period_min = limits->period_min_ns * 1000U;
+    const uint32_t period_max = limits->period_max_ns * 1000U;
+
+    for (uint8_t n = 3; n <= MIN(max_symbol_bits, 8); n++) {
+        const uint32_t period = n * bit_ps;
+        int32_t best_margin = -1;
+        uint8_t best_h0 = 0, best_h1 = 0;
+
+        int32_t period_margin = window_margin(period, period_min, period_max);
+        if (period_margin < 0) {
+            continue;
+        }
+
+        for (uint8_t h0 = 1; h0 < n; h0++) {
+            int32_t m0 = MIN(window_margin(h0 * bit_ps, t0h_min, t0h_max),
+                             (int32_t)((n - h0) * bit_ps) - (int32_t)tl_min);
+            if (m0 < 0) {
+                continue;
+            }
+
+            for (uint8_t h1 = h0 + 1; h1 < n; h1++) {
+                int32_t m1 = MIN(window_margin(h1 * bit_ps, t1h_min, t1h_max),
+                                 (int32_t)((n - h1) * bit_ps) - (int32_t)tl_min);
+                int32_t margin = MIN(MIN(m0, m1), period_margin);
+
+                if (m1 >= 0 && margin > best_margin) {
+                    best_margin = margin;
+                    best_h0 = h0;
+                    best_h1 = h1;
+                }
+            }
+        }
+
+        if (best_margin >= 0) {
+            enc->spi_hz = spi_hz;
+            enc->symbol_bits = n;
+            enc->zero_high_bits = best_h0;
+            enc->one_high_bits = best_h1;
+            enc->zero_symbol = ((1U << best_h0) - 1) << (n - best_h0);
+            enc->one_symbol = ((1U << best_h1) - 1) << (n - best_h1);
+            enc->spi_bit_ns = bit_ps / 1000U;
+            enc->t0h_ns = (best_h0 * bit_ps) / 1000U;
+            enc->t1h_ns = (best_h1 * bit_ps) / 1000U;
+            enc->period_ns = period / 1000U;
+            enc->margin_ns = best_margin / 1000;
+            return 0;
+        }
+    }
+
+    return -ENOTSUP;
+}
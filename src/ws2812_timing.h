@@ -0,0 +1,45 @@
+#ifndef WS2812_TIMING_H
+#define WS2812_TIMING_H
+
+#include <zephyr/kernel.h>
+
+// WS2812 waveform limits the synthesized SPI symbols must respect (ns)
+struct ws2812_timing {
+    uint16_t t0h_min_ns;     // High time of a 0 bit
+    uint16_t t0h_max_ns;
+    uint16_t t1h_min_ns;     // High time of a 1 bit
+    uint16_t t1h_max_ns;
+    uint16_t tl_min_ns;      // Low time after either bit
+    uint16_t period_min_ns;  // Full bit period
+    uint16_t period_max_ns;
+};
+
+// One WS2812 bit is sent as symbol_bits SPI bits: a run of high bits
+// followed by lows. A color byte therefore takes exactly symbol_bits
+// SPI bytes.
+struct ws2812_encoding {
+    uint32_t spi_hz;
+    uint8_t symbol_bits;     // SPI bits per WS2812 bit (3-8)
+    uint8_t zero_high_bits;  // High SPI bits in a 0 symbol
+    uint8_t one_high_bits;   // High SPI bits in a 1 symbol
+    uint8_t zero_symbol;     // Right-aligned symbol patterns
+    uint8_t one_symbol;
+    uint16_t spi_bit_ns;
+    uint16_t t0h_ns;
+    uint16_t t1h_ns;
+    uint16_t period_ns;
+    uint16_t margin_ns;      // Smallest distance to any timing limit
+};
+
+// Default limits from CONFIG_WS2812_T*_NS
+extern const struct ws2812_timing ws2812_default_timing;
+
+// Pick the densest symbol (fewest SPI bits per WS2812 bit, up to
+// max_symbol_bits) that meets the limits at spi_hz. Among equally dense
+// candidates the one with the largest margin wins.
+// Returns 0 on success, -ENOTSUP if no symbol fits.
+int ws2812_encoding_synthesize(uint32_t spi_hz, uint8_t max_symbol_bits,
+                               const struct ws2812_timing *limits,
+                               struct ws2812_encoding *enc);
+
+#endif /* WS2812_TIMING_H */